@@ -0,0 +1,90 @@
+/*
+ * ArcFlags.h
+ * Arc flags for one metric (driving or walking) of a graph split into regions: for every edge and direction
+ * it can be traversed in, one bit per region telling whether it starts a shortest path into that region.
+ * A search towards a region may then skip every edge whose bit for it is not set.
+ *
+ * Each traversal (slot, see slot()) owns one 64-bit row, so there are at most 64 regions and a test is one load.
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_ARCFLAGS
+#define DA_TP_CLASSES_ARCFLAGS
+
+#include <vector>
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+class ArcFlags {
+public:
+    static constexpr int MAX_REGIONS = 64;
+
+    /*
+     * Sizes the flags for (numSlots) traversals, with no bit set, over the partition (regionOf) of the vertices
+     * (by index) into (numRegions) regions.
+     */
+    void reset(std::vector<int> regionOf, int numRegions, size_t numSlots);
+    void clear();
+
+    bool empty() const;
+    int numRegions() const;
+    size_t bytes() const;
+    int region(int vertex) const;   // region of the vertex of that index
+
+    /*
+     * Slot of an edge traversed from its origin (forward) or, for a bidirectional edge, from its destination.
+     */
+    static size_t slot(int edgeIndex, bool forward);
+
+    void set(size_t slot, int region);   // may be called concurrently
+    bool test(size_t slot, int region) const;
+
+private:
+    std::vector<int> regionOf;
+    std::vector<uint64_t> rows;   // one row of region bits per slot
+    int regions = 0;
+};
+
+inline void ArcFlags::reset(std::vector<int> regionOf, int numRegions, size_t numSlots) {
+    this->regionOf = std::move(regionOf);
+    regions = numRegions;
+    rows.assign(numSlots, 0);
+}
+
+inline void ArcFlags::clear() {
+    regionOf = {};
+    rows = {};
+    regions = 0;
+}
+
+inline bool ArcFlags::empty() const {
+    return regions == 0;
+}
+
+inline int ArcFlags::numRegions() const {
+    return regions;
+}
+
+inline size_t ArcFlags::bytes() const {
+    return rows.size() * sizeof(uint64_t) + regionOf.size() * sizeof(int);
+}
+
+inline int ArcFlags::region(int vertex) const {
+    return regionOf[vertex];
+}
+
+inline size_t ArcFlags::slot(int edgeIndex, bool forward) {
+    return 2 * size_t(edgeIndex) + (forward ? 0 : 1);
+}
+
+inline void ArcFlags::set(size_t slot, int region) {
+    std::atomic_ref<uint64_t>(rows[slot]).fetch_or(uint64_t(1) << region, std::memory_order_relaxed);
+}
+
+inline bool ArcFlags::test(size_t slot, int region) const {
+    return rows[slot] >> region & 1;
+}
+
+#endif /* DA_TP_CLASSES_ARCFLAGS */
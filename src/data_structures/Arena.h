@@ -0,0 +1,125 @@
+/*
+ * Arena.h
+ * A monotonic slab arena, used by Graph to own its vertices and edges.
+ *
+ * Objects are constructed in place inside large slabs and are never freed individually:
+ * everything is released at once when the arena is cleared or destroyed.
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_ARENA
+#define DA_TP_CLASSES_ARENA
+
+#include <vector>
+#include <memory>
+#include <utility>
+#include <type_traits>
+
+template <class T>
+class Arena {
+public:
+    explicit Arena(size_t firstSlab = 64);
+    ~Arena();
+
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    /*
+     * Constructs a new object inside the current slab, opening a new (bigger) slab if it is full.
+     */
+    template <class... Args>
+    T *create(Args &&... args);
+
+    /*
+     * Destroys every object and releases all slabs.
+     * For trivially destructible types this only frees the slabs, so it does not depend on the number of objects.
+     */
+    void clear();
+
+    /*
+     * Exchanges the contents of two arenas, so that objects rebuilt in a new arena can replace the old ones.
+     */
+    void swap(Arena &other) noexcept;
+
+    size_t size() const;
+    size_t bytesReserved() const;
+
+private:
+    struct Slab {
+        T *data;
+        size_t capacity;
+        size_t used;
+    };
+
+    std::vector<Slab> slabs;
+    size_t nextSlab;
+    size_t count = 0;
+    std::allocator<T> alloc;
+
+    void grow();
+};
+
+template <class T>
+Arena<T>::Arena(const size_t firstSlab): nextSlab(firstSlab > 0 ? firstSlab : 1) {}
+
+template <class T>
+Arena<T>::~Arena() {
+    clear();
+}
+
+template <class T>
+template <class... Args>
+T *Arena<T>::create(Args &&... args) {
+    if (slabs.empty() || slabs.back().used == slabs.back().capacity)
+        grow();
+
+    Slab &s = slabs.back();
+    T *obj = s.data + s.used;
+    ::new (static_cast<void *>(obj)) T(std::forward<Args>(args)...);
+    s.used++;
+    count++;
+    return obj;
+}
+
+template <class T>
+void Arena<T>::grow() {
+    Slab s{alloc.allocate(nextSlab), nextSlab, 0};
+    slabs.push_back(s);
+    if (nextSlab < 16384) nextSlab *= 2; // geometric growth keeps the number of slabs logarithmic
+}
+
+template <class T>
+void Arena<T>::clear() {
+    for (auto &s : slabs) {
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            for (size_t i = 0; i < s.used; i++)
+                s.data[i].~T();
+        }
+        alloc.deallocate(s.data, s.capacity);
+    }
+    slabs.clear();
+    count = 0;
+}
+
+template <class T>
+void Arena<T>::swap(Arena &other) noexcept {
+    slabs.swap(other.slabs);
+    std::swap(nextSlab, other.nextSlab);
+    std::swap(count, other.count);
+}
+
+template <class T>
+size_t Arena<T>::size() const {
+    return count;
+}
+
+template <class T>
+size_t Arena<T>::bytesReserved() const {
+    size_t total = 0;
+    for (auto &s : slabs)
+        total += s.capacity * sizeof(T);
+    return total;
+}
+
+#endif /* DA_TP_CLASSES_ARENA */
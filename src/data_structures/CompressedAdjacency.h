@@ -0,0 +1,178 @@
+/*
+ * CompressedAdjacency.h
+ * Compressed adjacency lists for one metric (driving or walking) of a graph.
+ *
+ * The neighbours of each vertex are sorted and delta-coded as varints (the first one relative to the vertex
+ * itself, so a locality-preserving numbering keeps most deltas in one byte), and the weights are bit-packed
+ * with just enough bits for the largest weight of the metric.
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_COMPRESSEDADJACENCY
+#define DA_TP_CLASSES_COMPRESSEDADJACENCY
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <numeric>
+#include <type_traits>
+
+template <class W>
+class CompressedAdjacency {
+public:
+    /*
+     * Encodes a plain CSR adjacency: the neighbours of vertex u are targets[offsets[u] .. offsets[u+1]),
+     * with the matching weights. Weights must be unsigned integers.
+     */
+    void build(const std::vector<uint32_t> &offsets, const std::vector<uint32_t> &targets, const std::vector<W> &weights);
+    void clear();
+
+    /*
+     * Calls f(neighbour, weight) for every neighbour of vertex (u), in increasing neighbour order.
+     */
+    template <class F>
+    void forEach(int u, F &&f) const;
+
+    bool empty() const;
+    size_t numEntries() const;
+    size_t bytes() const;
+
+private:
+    std::vector<uint32_t> byteOffset;   // start of each vertex in the stream (V+1 entries)
+    std::vector<uint32_t> firstEntry;   // ordinal of the first entry of each vertex, to locate its weights (V+1 entries)
+    std::vector<uint8_t> stream;        // varint neighbour deltas
+    std::vector<uint64_t> packed;       // weights, bitsPerWeight bits each
+    unsigned bitsPerWeight = 1;
+
+    void putVarint(uint32_t x);
+    static uint32_t getVarint(const uint8_t *&p);
+    W weightAt(size_t entry) const;
+};
+
+template <class W>
+void CompressedAdjacency<W>::clear() {
+    byteOffset.clear();
+    firstEntry.clear();
+    stream.clear();
+    packed.clear();
+    bitsPerWeight = 1;
+}
+
+template <class W>
+bool CompressedAdjacency<W>::empty() const {
+    return byteOffset.empty();
+}
+
+template <class W>
+size_t CompressedAdjacency<W>::numEntries() const {
+    return firstEntry.empty() ? 0 : firstEntry.back();
+}
+
+template <class W>
+size_t CompressedAdjacency<W>::bytes() const {
+    return (byteOffset.size() + firstEntry.size()) * sizeof(uint32_t) + stream.size() + packed.size() * sizeof(uint64_t);
+}
+
+template <class W>
+void CompressedAdjacency<W>::putVarint(uint32_t x) {
+    while (x >= 0x80) {
+        stream.push_back(static_cast<uint8_t>(x | 0x80));
+        x >>= 7;
+    }
+    stream.push_back(static_cast<uint8_t>(x));
+}
+
+template <class W>
+uint32_t CompressedAdjacency<W>::getVarint(const uint8_t *&p) {
+    uint32_t x = *p++;
+    if (x < 0x80) return x; // fast path: one byte
+    x &= 0x7f;
+    unsigned shift = 7;
+    while (true) {
+        uint32_t b = *p++;
+        x |= (b & 0x7f) << shift;
+        if (b < 0x80) return x;
+        shift += 7;
+    }
+}
+
+template <class W>
+W CompressedAdjacency<W>::weightAt(const size_t entry) const {
+    size_t bit = entry * bitsPerWeight;
+    size_t word = bit >> 6;
+    unsigned off = bit & 63;
+    uint64_t x = packed[word] >> off;
+    if (off + bitsPerWeight > 64)
+        x |= packed[word + 1] << (64 - off);
+    return static_cast<W>(x & ((uint64_t(1) << bitsPerWeight) - 1));
+}
+
+template <class W>
+void CompressedAdjacency<W>::build(const std::vector<uint32_t> &offsets, const std::vector<uint32_t> &targets, const std::vector<W> &weights) {
+    static_assert(std::is_unsigned_v<W> && sizeof(W) <= 4, "CompressedAdjacency needs unsigned integer weights of at most 32 bits");
+    clear();
+
+    size_t n = offsets.empty() ? 0 : offsets.size() - 1;
+    W maxWeight = 0;
+    for (W w : weights)
+        maxWeight = std::max(maxWeight, w);
+    while (bitsPerWeight < 8 * sizeof(W) && (uint64_t(maxWeight) >> bitsPerWeight) != 0)
+        bitsPerWeight++;
+
+    packed.assign((targets.size() * bitsPerWeight + 63) / 64 + 1, 0);
+    byteOffset.reserve(n + 1);
+    firstEntry.reserve(n + 1);
+
+    std::vector<uint32_t> order;
+    size_t entry = 0;
+    for (size_t u = 0; u < n; u++) {
+        byteOffset.push_back(stream.size());
+        firstEntry.push_back(entry);
+
+        order.resize(offsets[u + 1] - offsets[u]);
+        std::iota(order.begin(), order.end(), offsets[u]);
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return targets[a] < targets[b]; });
+
+        int64_t prev = u;
+        bool first = true;
+        for (uint32_t i : order) {
+            int64_t delta = int64_t(targets[i]) - prev;
+            if (first) // zigzag: the first neighbour may come before the vertex
+                putVarint(static_cast<uint32_t>(delta < 0 ? -2 * delta - 1 : 2 * delta));
+            else
+                putVarint(static_cast<uint32_t>(delta));
+            first = false;
+            prev = targets[i];
+
+            size_t bit = entry * bitsPerWeight;
+            packed[bit >> 6] |= uint64_t(weights[i]) << (bit & 63);
+            if ((bit & 63) + bitsPerWeight > 64)
+                packed[(bit >> 6) + 1] |= uint64_t(weights[i]) >> (64 - (bit & 63));
+            entry++;
+        }
+    }
+    byteOffset.push_back(stream.size());
+    firstEntry.push_back(entry);
+    stream.push_back(0); // padding, so the decoder never reads past the end
+}
+
+template <class W>
+template <class F>
+void CompressedAdjacency<W>::forEach(const int u, F &&f) const {
+    const uint8_t *p = stream.data() + byteOffset[u];
+    const uint8_t *end = stream.data() + byteOffset[u + 1];
+    size_t entry = firstEntry[u];
+    if (p == end) return;
+
+    uint32_t z = getVarint(p);
+    int64_t n = int64_t(u) + ((z & 1) ? -int64_t((z + 1) >> 1) : int64_t(z >> 1));
+    f(static_cast<int>(n), weightAt(entry++));
+
+    while (p < end) {
+        n += getVarint(p);
+        f(static_cast<int>(n), weightAt(entry++));
+    }
+}
+
+#endif /* DA_TP_CLASSES_COMPRESSEDADJACENCY */
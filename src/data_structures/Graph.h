@@ -6,79 +6,118 @@
     Adaptations:
     - changed visited and respective methods to restricted, just to better show the nature of the problem
     - Added two types of distances (dist_walk and dist_drive)
-    - Added restricted attribute to Edge
+    - Vertices and edges are owned by the graph through slab arenas (no individual new/delete)
+    - A bidirectional segment is a single Edge, listed in the adjacency of both endpoints (replaces reverse)
+    - Per-mode adjacency views (adj_drive/adj_walk) that only hold edges usable by that mode
+    - Hot/cold split: search state lives in per-metric SearchTrees indexed by the vertex index,
+      and location names/codes are interned in the graph's StringTable (vertices keep integer handles)
+    - Adjacency and vertex set accessors return read-only spans instead of copies
+    - Weight and distance types come from WeightTraits<T>: Graph<int> uses 16-bit minute weights
+      and 32-bit distances, with integer sentinels instead of std::numeric_limits<double>::max()
+    - Optional compressed per-metric adjacency (CompressedAdjacency) and vertex renumbering
+    - Renumbering also relocates the vertices and edges in the new order, and vertices are found by ID through
+      a hash map, so the internal order never shows outside the graph
+    - Optional structure-of-arrays per-metric adjacency (SoAAdjacency) for block relaxation kernels
+    - Restricted flags moved out of Vertex and Edge into per-query Restrictions masks: edges are numbered,
+      and the edges of a segment are found by their endpoints' IDs through a hash map
+    - Per-mode connected-component labels, to reject queries between disconnected vertices without searching
+    - Optional LRU cache of complete search trees, reused by later queries from the same origin or to the same destination
  */
 
 #ifndef DA_TP_CLASSES_GRAPH
 #define DA_TP_CLASSES_GRAPH
 
 #include <vector>
+#include <span>
 #include <limits>
 #include <string>
-#include "../data_structures/MutablePriorityQueue.h" // not needed for now
+#include <cstdint>
+#include <algorithm>
+#include <unordered_map>
+#include <list>
+#include <mutex>
+#include "../data_structures/Arena.h"
+#include "../data_structures/StringTable.h"
+#include "../data_structures/IndexedPriorityQueue.h"
+#include "../data_structures/CompressedAdjacency.h"
+#include "../data_structures/SoAAdjacency.h"
+#include "../data_structures/HubLabels.h"
+#include "../data_structures/ArcFlags.h"
+#include "../data_structures/ParkingIndex.h"
 
 template <class T>
 class Edge;
 
-#define INF std::numeric_limits<double>::max()
+template <class T>
+class Graph;
+
+/************************* WeightTraits  **************************/
+
+/*
+ * Types used for the edge weights and search distances of a Graph<T>.
+ * NO_EDGE marks a segment that cannot be used by a mode; INF marks an unreached vertex.
+ */
+template <class T>
+struct WeightTraits {
+    using Weight = double;
+    using Distance = double;
+    static constexpr Weight NO_EDGE = std::numeric_limits<double>::max();
+    static constexpr Distance INF = std::numeric_limits<double>::max();
+};
+
+/*
+ * Graph<int>: weights are whole minutes (as in the distances file), so they fit in 16 bits,
+ * and any path fits in 32 bits.
+ */
+template <>
+struct WeightTraits<int> {
+    using Weight = uint16_t;
+    using Distance = uint32_t;
+    static constexpr Weight NO_EDGE = UINT16_MAX;
+    static constexpr Distance INF = UINT32_MAX;
+};
 
 /************************* Vertex  **************************/
 
 template <class T>
 class Vertex {
 public:
-    Vertex(const std::string &location, int id, const std::string &code, bool parking);
-    bool operator<(Vertex<T> & vertex) const; // // required by MutablePriorityQueue
+    Vertex(Symbol location, int id, Symbol code, bool parking, int index);
 
-    std::string getCode() const;
-    std::string getLocation() const;
+    Symbol getCode() const;      // handle in the graph's string table (see Graph::getName)
+    Symbol getLocation() const;  // handle in the graph's string table (see Graph::getName)
     int getID() const;
+    int getIndex() const;
     bool hasParking() const;
-    std::vector<Edge<T> *> getAdj() const;
-    bool isRestricted() const;
-    double getDistWalk() const;
-    double getDistDrive() const;
-    Edge<T> *getPathDrive() const;
-    Edge<T> *getPathWalk() const;
-    std::vector<Edge<T> *> getIncoming() const;
-
-    void setRestricted(bool restricted);
-
-    void setDistWalk(double dist_walk);
-    void setDistDrive(double dist_drive);
-    void setPathDrive(Edge<T> *path);
-    void setPathWalk(Edge<T> *path);
-    Edge<T> * addEdge(Vertex<T> *dest, double wd, double ww);
+    std::span<Edge<T> * const> getAdj() const;
+    std::span<Edge<T> * const> getAdjDrive() const;
+    std::span<Edge<T> * const> getAdjWalk() const;
+    std::span<Edge<T> * const> getIncoming() const;
+
+    void setIndex(int index);
+
+    void addEdge(Edge<T> *edge);
     bool removeEdge(T in);
     void removeOutgoingEdges();
 
-    bool getWalking();
-    void setWalking(bool set);
-
-    friend class MutablePriorityQueue<Vertex>;
 protected:
 
-    const std::string location_name;
     const int id;
-    const std::string code;
+    const Symbol location_name;
+    const Symbol code;
+    int index; // position in the vertex set, used to address the search arrays
     const bool parking;
 
-    bool walking = false;    //Support for eco mode
-
-    std::vector<Edge<T> *> adj;  // outgoing edges
-
-    // auxiliary fields
-    bool restricted = false; // used to implement restrictions on graph travel (replaced visited)
-    double dist_walk = 0;
-    double dist_drive = 0;
-    Edge<T> *path_drive = nullptr;
-    Edge<T> *path_walk = nullptr;
-
-    std::vector<Edge<T> *> incoming; // incoming edges
+    std::vector<Edge<T> *> adj;  // outgoing edges (bidirectional segments are listed at both endpoints)
+    std::vector<Edge<T> *> adj_drive;  // outgoing edges that can be driven (weight_drive != NO_EDGE)
+    std::vector<Edge<T> *> adj_walk;   // outgoing edges that can be walked (weight_walk != NO_EDGE)
 
-    int queueIndex = 0; 		// required by MutablePriorityQueue and UFDS
+    std::vector<Edge<T> *> incoming; // incoming directed edges (bidirectional segments only live in adj)
 
     void deleteEdge(Edge<T> *edge);
+    void dropFromViews(Edge<T> *edge);
+
+    friend class Graph<T>; // relinks the adjacency when relocating vertices
 };
 
 /********************** Edge  ****************************/
@@ -86,31 +125,173 @@ protected:
 template <class T>
 class Edge {
 public:
-    Edge(Vertex<T> *orig, Vertex<T> *dest, double wd, double ww);
+    using Weight = typename WeightTraits<T>::Weight;
+
+    Edge(Vertex<T> *orig, Vertex<T> *dest, Weight wd, Weight ww, bool bidirectional = false, int index = 0);
 
     Vertex<T> * getDest() const;
-    double getWeightDrive() const;
-    double getWeightWalk() const;
+    Weight getWeightDrive() const;
+    Weight getWeightWalk() const;
     bool isSelected() const;
-    bool isRestricted() const;
+    bool isBidirectional() const;
+    int getIndex() const; // number of the edge in its graph, used to address per-query masks
     Vertex<T> * getOrig() const;
-    Edge<T> *getReverse() const;
-    void setRestricted(bool restricted);
+    /*
+     * Returns the endpoint reached when traversing this edge from (from).
+     * For a directed edge, (from) must be its origin.
+     */
+    Vertex<T> * getOther(const Vertex<T> *from) const;
     void setSelected(bool selected);
-    void setReverse(Edge<T> *reverse);
 
 protected:
+    Vertex<T> *orig; // origin vertex (first endpoint of a bidirectional segment)
     Vertex<T> * dest; // destination vertex
-    double weight_drive; // edge driving weight
-    double weight_walk; //edge walking weight
-    bool restricted = false;
+    Weight weight_drive; // edge driving weight
+    Weight weight_walk; //edge walking weight
 
     // auxiliary fields
     bool selected = false;
 
-    // used for bidirectional edges
-    Vertex<T> *orig;
-    Edge<T> *reverse = nullptr;
+    const bool bidirectional;
+    const int index;
+
+    friend class Graph<T>; // relinks the endpoints when relocating vertices
+};
+
+template <class T> class AllPairsTable;
+template <class T> class TreeCache;
+
+/********************** SearchTree  ****************************/
+
+/*
+ * Hot data of a single-source search for one metric (driving or walking): distance and edge used to reach
+ * each vertex, kept in arrays indexed by Vertex::getIndex() instead of inside the vertices.
+ */
+template <class T>
+class SearchTree {
+public:
+    using Distance = typename WeightTraits<T>::Distance;
+
+    /*
+     * Sizes the arrays for (n) vertices, with every distance at INF and no path.
+     */
+    void reset(size_t n);
+
+    Distance getDist(const Vertex<T> *v) const;
+    Edge<T> *getPath(const Vertex<T> *v) const;
+    void setDist(const Vertex<T> *v, Distance dist);
+    void setPath(const Vertex<T> *v, Edge<T> *path);
+
+    const std::vector<Distance> &getDistances() const; // keys of the search's priority queue
+
+    /*
+     * Priority queue keyed by this tree's distances, reset by reset() and reused across searches,
+     * so that a search does not allocate once the arrays have been sized.
+     */
+    IndexedPriorityQueue<Distance> &getQueue();
+
+protected:
+    std::vector<Distance> dist;
+    std::vector<Edge<T> *> path;
+    IndexedPriorityQueue<Distance> queue;
+
+    friend class AllPairsTable<T>; // copies whole rows in and out
+    friend class TreeCache<T>;     // and so does the tree cache
+};
+
+/********************** AllPairsTable  ****************************/
+
+/*
+ * Distances and last edges between every pair of vertices for one metric, in two contiguous n x n arrays:
+ * row i is the SearchTree of a search from the vertex of index i. Paths are read backwards from the
+ * destination through the row, so a lookup costs the length of the path.
+ */
+template <class T>
+class AllPairsTable {
+public:
+    using Distance = typename WeightTraits<T>::Distance;
+
+    /*
+     * Sizes the table for (n) vertices, with every distance at INF and no path.
+     */
+    void resize(size_t n);
+    void clear();
+    bool empty() const;
+    size_t size() const;    // number of vertices (rows)
+    size_t bytes() const;
+
+    Distance getDist(const Vertex<T> *from, const Vertex<T> *to) const;
+    Edge<T> *getPath(const Vertex<T> *from, const Vertex<T> *to) const;
+
+    void store(size_t row, const SearchTree<T> &tree);   // row (row) becomes the result of (tree)
+    void load(size_t row, SearchTree<T> &tree) const;    // (tree) becomes the result of the search of row (row)
+
+protected:
+    std::vector<Distance> distMatrix;   // distMatrix[i * n + j]: distance from vertex i to vertex j
+    std::vector<Edge<T> *> pathMatrix;  // pathMatrix[i * n + j]: last edge of that path (nullptr if none)
+    size_t n = 0;
+};
+
+/********************** TreeCache  ****************************/
+
+/*
+ * Complete search trees kept between queries: driving trees by origin and walking trees by destination, each under
+ * the restrictions it was searched with (by their hash, see Restrictions::hash). Only the distance and path arrays
+ * are kept, and the least recently used trees are dropped once they take more than the byte budget; a budget of 0
+ * (the default) keeps nothing. Trees may be loaded and stored from several threads at once.
+ */
+template <class T>
+class TreeCache {
+public:
+    using Distance = typename WeightTraits<T>::Distance;
+
+    struct Stats {
+        size_t hits = 0;
+        size_t misses = 0;
+        size_t evictions = 0;   // trees dropped to make room
+    };
+
+    void setBudget(size_t bytes);   // drops the least recently used trees that no longer fit
+    size_t budget() const;
+    bool enabled() const;           // the budget is not 0
+    void clear();                   // drops every tree, but keeps the counts
+
+    /*
+     * If the tree searched from vertex index (root) in that metric under restrictions of hash (restrictions) is
+     * cached, (tree) becomes it and it becomes the most recently used. Counts a hit or a miss.
+     */
+    bool load(int root, bool driving, uint64_t restrictions, SearchTree<T> &tree);
+    void store(int root, bool driving, uint64_t restrictions, const SearchTree<T> &tree);
+
+    Stats stats() const;
+    size_t size() const;    // number of trees
+    size_t bytes() const;   // taken by their arrays
+
+protected:
+    struct Key {
+        int root;
+        bool driving;
+        uint64_t restrictions;
+        bool operator==(const Key &) const = default;
+    };
+    struct KeyHash {
+        size_t operator()(const Key &key) const;
+    };
+    struct Entry {
+        Key key;
+        std::vector<Distance> dist;
+        std::vector<Edge<T> *> path;
+    };
+
+    std::list<Entry> entries;   // most recently used first
+    std::unordered_map<Key, typename std::list<Entry>::iterator, KeyHash> byKey;
+    size_t limit = 0;
+    size_t used = 0;
+    Stats counts;
+    mutable std::mutex lock;
+
+    static size_t bytes(const Entry &entry);
+    void evict(); // the least recently used trees, down to the budget (with the lock held)
 };
 
 /********************** Graph  ****************************/
@@ -118,13 +299,25 @@ protected:
 template <class T>
 class Graph {
 public:
-    ~Graph();
+    using Weight = typename WeightTraits<T>::Weight;
+
+    Graph() = default;
+
+    Graph(const Graph &) = delete;
+    Graph &operator=(const Graph &) = delete;
+
     /*
     * Auxiliary function to find a vertex with a given the content.
     */
     Vertex<T> *findVertex(int id) const;
 
-    Vertex<T> *findVertexCode(std::string code) const;
+    Vertex<T> *findVertexCode(const std::string &code) const;
+    Vertex<T> *getVertex(int index) const;
+
+    /*
+     * Returns the string behind a handle returned by Vertex::getCode or Vertex::getLocation.
+     */
+    const std::string &getName(Symbol handle) const;
     /*
      *  Adds a vertex with a given content or info (in) to a graph (this).
      *  Returns true if successful, and false if a vertex with that content already exists.
@@ -137,19 +330,137 @@ public:
      * destination vertices and the edge weight (w).
      * Returns true if successful, and false if the source or destination vertex does not exist.
      */
-    bool addEdge(const T &sourc, const T &dest, double wd, double ww);
+    bool addEdge(const T &sourc, const T &dest, Weight wd, Weight ww);
     bool removeEdge(const T &source, const T &dest);
-    bool addBidirectionalEdge(const T &sourc, const T &dest, double wd, double ww);
+    bool addBidirectionalEdge(const T &sourc, const T &dest, Weight wd, Weight ww);
+
+    /*
+     * Returns the edges that can be traversed from (sourc) to (dest): the directed edges sourc -> dest and the
+     * bidirectional segments between both. One hash lookup, instead of a scan of the adjacency of (sourc).
+     */
+    std::vector<Edge<T> *> findSegment(const T &sourc, const T &dest) const;
 
     int getNumVertex() const;
+    /*
+     * Upper bound of the edge indices: removed edges keep theirs until the vertices are reordered.
+     */
+    int getNumEdgeIndices() const;
+
+    std::span<Vertex<T> * const> getVertexSet() const;
+
+    SearchTree<T> &getDriveTree();
+    SearchTree<T> &getWalkTree();
+
+    /*
+     * All-pairs driving and walking tables, empty unless filled at load time (see computeAllPairs).
+     * Any later change to the vertices or edges clears them.
+     */
+    AllPairsTable<T> &getDriveTable();
+    AllPairsTable<T> &getWalkTable();
+
+    /*
+     * Driving and walking hub labels, by vertex index, empty unless built at load time (see computeHubLabels).
+     * Any later change to the vertices or edges clears them.
+     */
+    HubLabels &getDriveLabels();
+    HubLabels &getWalkLabels();
+
+    /*
+     * Driving and walking arc flags, by edge slot (see ArcFlags::slot), empty unless built at load time
+     * (see computeArcFlags). Any later change to the vertices or edges clears them.
+     */
+    ArcFlags &getDriveFlags();
+    ArcFlags &getWalkFlags();
+
+    /*
+     * Parking vertices within a walking budget of each vertex, empty unless built at load time
+     * (see computeParkingIndex). Any later change to the vertices or edges clears it.
+     */
+    ParkingIndex &getParkingIndex();
+
+    /*
+     * Complete driving and walking trees of earlier queries, empty and disabled unless given a budget at load time.
+     * Any later change to the vertices or edges empties it.
+     */
+    TreeCache<T> &getTreeCache();
 
-    std::vector<Vertex<T> *> getVertexSet() const;
+    /*
+     * Renumbers the vertices: the vertex at position order[k] of the vertex set moves to position k.
+     * Vertices are rebuilt contiguously in that order, and edges in the order they are first met in the
+     * new adjacency, so pointers to vertices and edges taken before the call are no longer valid.
+     * IDs and codes are unchanged; only the storage order (and so the search array layout) changes.
+     */
+    void reorderVertices(const std::vector<int> &order);
+
+    /*
+     * Builds the compressed driving and walking adjacency from the per-mode views.
+     * Any later change to the edges drops it, so it should be built once loading is done.
+     */
+    void compressAdjacency();
+    void dropCompressedAdjacency();
+    const CompressedAdjacency<Weight> *getCompressedDrive() const; // nullptr when not built
+    const CompressedAdjacency<Weight> *getCompressedWalk() const;  // nullptr when not built
+
+    /*
+     * Builds the structure-of-arrays driving and walking adjacency, in the order of the per-mode views.
+     * Like the compressed adjacency, it is dropped by any later change to the vertices or edges.
+     */
+    void buildSoAAdjacency();
+    void dropSoAAdjacency();
+    const SoAAdjacency<Weight, Edge<T>> *getSoADrive() const; // nullptr when not built
+    const SoAAdjacency<Weight, Edge<T>> *getSoAWalk() const;  // nullptr when not built
+
+    /*
+     * Labels the weakly connected components of the driving and walking views (union-find over their edges).
+     * Vertices with different labels can never reach each other in that mode; vertices with the same label may,
+     * if some edges are directed. Any later change to the vertices or edges drops the labels.
+     */
+    void labelComponents();
+    bool hasComponents() const;
+    int getDriveComponent(const Vertex<T> *v) const; // only valid if hasComponents()
+    int getWalkComponent(const Vertex<T> *v) const;  // only valid if hasComponents()
 
 protected:
     std::vector<Vertex<T> *> vertexSet;    // vertex set
 
-    double ** distMatrix = nullptr;   // dist matrix for Floyd-Warshall
-    int **pathMatrix = nullptr;   // path matrix for Floyd-Warshall
+    StringTable names;                 // interned location names and codes
+    std::vector<Vertex<T> *> byCode;   // vertex of each code handle (nullptr for other handles)
+    std::unordered_map<int, Vertex<T> *> byID;   // external ID -> vertex, whatever its position
+    std::unordered_multimap<uint64_t, Edge<T> *> bySegment;   // (sourc ID, dest ID) -> edges traversable that way
+
+    SearchTree<T> driveTree;   // state of the last driving search
+    SearchTree<T> walkTree;    // state of the last walking search
+
+    CompressedAdjacency<Weight> compressedDrive;
+    CompressedAdjacency<Weight> compressedWalk;
+
+    SoAAdjacency<Weight, Edge<T>> soaDrive;
+    SoAAdjacency<Weight, Edge<T>> soaWalk;
+
+    std::vector<int> driveComponent;   // component label of each vertex index (empty if not labelled)
+    std::vector<int> walkComponent;
+
+    Arena<Vertex<T>> vertexArena;   // owns every vertex ever added
+    Arena<Edge<T>> edgeArena;       // owns every edge ever added
+
+    AllPairsTable<T> driveTable;
+    AllPairsTable<T> walkTable;
+
+    HubLabels driveLabels;
+    HubLabels walkLabels;
+
+    ArcFlags driveFlags;
+    ArcFlags walkFlags;
+
+    ParkingIndex parkingIndex;
+
+    TreeCache<T> treeCache;
+
+    void dropDerivedAdjacency(); // adjacency layouts, components, tables, labels, flags, parking index and cached trees
+
+    static uint64_t segmentKey(const T &sourc, const T &dest);
+    void indexSegment(Edge<T> *e);
+    void reindexSegments(); // after edges are removed or relocated
 
     /**
     * Auxiliary function to set the "path" field to make a spanning tree.
@@ -157,24 +468,25 @@ protected:
 
 };
 
-void deleteMatrix(int **m, int n);
-void deleteMatrix(double **m, int n);
-
 
 /************************* Vertex  **************************/
 
 template <class T>
-Vertex<T>::Vertex(const std::string &location, int id, const std::string &code, bool parking): location_name(location), id(id), code(code), parking(parking) {}
+Vertex<T>::Vertex(Symbol location, int id, Symbol code, bool parking, int index): id(id), location_name(location), code(code), index(index), parking(parking) {}
+
 /*
- * Auxiliary function to add an outgoing edge to a vertex (this),
- * with a given destination vertex (d) and edge weight (w).
+ * Auxiliary function to add an outgoing edge (already allocated by the graph) to a vertex (this).
+ * The edge is also added to the driving/walking views if it can be used by that mode.
  */
 template <class T>
-Edge<T> * Vertex<T>::addEdge(Vertex<T> *d, double wd, double ww) {
-    auto newEdge = new Edge<T>(this, d, wd, ww);
-    adj.push_back(newEdge);
-    d->incoming.push_back(newEdge);
-    return newEdge;
+void Vertex<T>::addEdge(Edge<T> *edge) {
+    adj.push_back(edge);
+    if (edge->getWeightDrive() != WeightTraits<T>::NO_EDGE)
+        adj_drive.push_back(edge);
+    if (edge->getWeightWalk() != WeightTraits<T>::NO_EDGE)
+        adj_walk.push_back(edge);
+    if (!edge->isBidirectional())
+        edge->getDest()->incoming.push_back(edge);
 }
 
 /*
@@ -188,9 +500,8 @@ bool Vertex<T>::removeEdge(T in) {
     auto it = adj.begin();
     while (it != adj.end()) {
         Edge<T> *edge = *it;
-        Vertex<T> *dest = edge->getDest();
-        //To be properly adapted
-        if (dest->getCode() == in) {
+        Vertex<T> *dest = edge->getOther(this);
+        if (dest->getID() == in) {
             it = adj.erase(it);
             deleteEdge(edge);
             removedEdge = true; // allows for multiple edges to connect the same pair of vertices (multigraph)
@@ -216,16 +527,7 @@ void Vertex<T>::removeOutgoingEdges() {
 }
 
 template <class T>
-bool Vertex<T>::operator<(Vertex<T> & vertex) const {
-    //WARNING: TO BE VERIFIED
-    if (walking)
-        return this->dist_walk < vertex.dist_walk;
-
-    return this->dist_drive < vertex.dist_drive;
-}
-
-template <class T>
-std::string Vertex<T>::getLocation() const {
+Symbol Vertex<T>::getLocation() const {
     return this->location_name;
 }
 
@@ -235,7 +537,12 @@ int Vertex<T>::getID() const {
 }
 
 template <class T>
-std::string Vertex<T>::getCode() const {
+int Vertex<T>::getIndex() const {
+    return this->index;
+}
+
+template <class T>
+Symbol Vertex<T>::getCode() const {
     return this->code;
 }
 
@@ -245,148 +552,310 @@ bool Vertex<T>::hasParking() const {
 }
 
 template <class T>
-std::vector<Edge<T>*> Vertex<T>::getAdj() const {
+std::span<Edge<T> * const> Vertex<T>::getAdj() const {
     return this->adj;
 }
 
 template <class T>
-bool Vertex<T>::isRestricted() const {
-    return this->restricted;
+std::span<Edge<T> * const> Vertex<T>::getAdjDrive() const {
+    return this->adj_drive;
 }
 
 template <class T>
-double Vertex<T>::getDistWalk() const {
-    return this->dist_walk;
+std::span<Edge<T> * const> Vertex<T>::getAdjWalk() const {
+    return this->adj_walk;
 }
 
 template <class T>
-double Vertex<T>::getDistDrive() const {
-    return this->dist_drive;
+std::span<Edge<T> * const> Vertex<T>::getIncoming() const {
+    return this->incoming;
 }
 
 template <class T>
-Edge<T> *Vertex<T>::getPathDrive() const {
-    return this->path_drive;
+void Vertex<T>::setIndex(int index) {
+    this->index = index;
 }
 
 template <class T>
-Edge<T> *Vertex<T>::getPathWalk() const {
-    return this->path_walk;
+void Vertex<T>::deleteEdge(Edge<T> *edge) {
+    Vertex<T> *dest = edge->getOther(this);
+    dropFromViews(edge);
+
+    if (edge->isBidirectional()) {
+        // Remove the shared segment from the other endpoint's adjacency
+        auto it = dest->adj.begin();
+        while (it != dest->adj.end()) {
+            if (*it == edge)
+                it = dest->adj.erase(it);
+            else
+                it++;
+        }
+        dest->dropFromViews(edge);
+        return;
+    }
+
+    // Remove the corresponding edge from the incoming list
+    auto it = dest->incoming.begin();
+    while (it != dest->incoming.end()) {
+        if ((*it)->getOrig()->getCode() == code) {
+            it = dest->incoming.erase(it);
+        }
+        else {
+            it++;
+        }
+    }
+    // the edge itself stays in the graph's arena until the graph is destroyed
 }
 
+/*
+ * Auxiliary function to remove an edge from the per-mode views of a vertex (this).
+ */
 template <class T>
-std::vector<Edge<T> *> Vertex<T>::getIncoming() const {
-    return this->incoming;
+void Vertex<T>::dropFromViews(Edge<T> *edge) {
+    std::erase(adj_drive, edge);
+    std::erase(adj_walk, edge);
 }
 
+/********************** Edge  ****************************/
+
 template <class T>
-void Vertex<T>::setRestricted(bool restricted) {
-    this->restricted = restricted;
+Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, Weight wd, Weight ww, bool bidirectional, int index): orig(orig), dest(dest), weight_drive(wd), weight_walk(ww), bidirectional(bidirectional), index(index){}
+
+template <class T>
+Vertex<T> * Edge<T>::getDest() const {
+    return this->dest;
 }
 
+
 template <class T>
-void Vertex<T>::setDistWalk(double dist_walk) {
-    this->dist_walk = dist_walk;
+typename Edge<T>::Weight Edge<T>::getWeightDrive() const {
+    return this->weight_drive;
 }
 
 template <class T>
-void Vertex<T>::setDistDrive(double dist_drive) {
-    this->dist_drive = dist_drive;
+typename Edge<T>::Weight Edge<T>::getWeightWalk() const {
+    return this->weight_walk;
 }
 
+template <class T>
+Vertex<T> * Edge<T>::getOrig() const {
+    return this->orig;
+}
 
 template <class T>
-void Vertex<T>::setPathDrive(Edge<T> *path) {
-    this->path_drive = path;
+Vertex<T> * Edge<T>::getOther(const Vertex<T> *from) const {
+    return from == this->orig ? this->dest : this->orig;
 }
 
 template <class T>
-void Vertex<T>::setPathWalk(Edge<T> *path) {
-    this->path_walk = path;
+bool Edge<T>::isSelected() const {
+    return this->selected;
 }
 
 template <class T>
-void Vertex<T>::deleteEdge(Edge<T> *edge) {
-    Vertex<T> *dest = edge->getDest();
-    // Remove the corresponding edge from the incoming list
-    auto it = dest->incoming.begin();
-    while (it != dest->incoming.end()) {
-        if ((*it)->getOrig()->getCode() == code) {
-            it = dest->incoming.erase(it);
-        }
-        else {
-            it++;
-        }
-    }
-    delete edge;
+bool Edge<T>::isBidirectional() const {
+    return this->bidirectional;
 }
 
 template <class T>
-bool Vertex<T>::getWalking() {
-    return walking;
+int Edge<T>::getIndex() const {
+    return this->index;
 }
 
 template <class T>
-void Vertex<T>::setWalking(bool set) {
-    this->walking = set;
+void Edge<T>::setSelected(bool selected) {
+    this->selected = selected;
 }
 
-/********************** Edge  ****************************/
+
+/********************** SearchTree  ****************************/
 
 template <class T>
-Edge<T>::Edge(Vertex<T> *orig, Vertex<T> *dest, double wd, double ww): orig(orig), dest(dest), weight_drive(wd), weight_walk(ww){}
+void SearchTree<T>::reset(size_t n) {
+    dist.assign(n, WeightTraits<T>::INF);
+    path.assign(n, nullptr);
+    queue.reset(dist);
+}
 
 template <class T>
-Vertex<T> * Edge<T>::getDest() const {
-    return this->dest;
+typename SearchTree<T>::Distance SearchTree<T>::getDist(const Vertex<T> *v) const {
+    return this->dist[v->getIndex()];
 }
 
-template<class T>
-void Edge<T>::setRestricted(bool restricted) {
-    this->restricted = restricted;
+template <class T>
+Edge<T> *SearchTree<T>::getPath(const Vertex<T> *v) const {
+    return this->path[v->getIndex()];
 }
 
+template <class T>
+void SearchTree<T>::setDist(const Vertex<T> *v, Distance dist) {
+    this->dist[v->getIndex()] = dist;
+}
 
 template <class T>
-double Edge<T>::getWeightDrive() const {
-    return this->weight_drive;
+void SearchTree<T>::setPath(const Vertex<T> *v, Edge<T> *path) {
+    this->path[v->getIndex()] = path;
 }
 
 template <class T>
-double Edge<T>::getWeightWalk() const {
-    return this->weight_walk;
+const std::vector<typename SearchTree<T>::Distance> &SearchTree<T>::getDistances() const {
+    return this->dist;
 }
 
 template <class T>
-Vertex<T> * Edge<T>::getOrig() const {
-    return this->orig;
+IndexedPriorityQueue<typename SearchTree<T>::Distance> &SearchTree<T>::getQueue() {
+    return this->queue;
 }
 
+/********************** AllPairsTable  ****************************/
+
 template <class T>
-Edge<T> *Edge<T>::getReverse() const {
-    return this->reverse;
+void AllPairsTable<T>::resize(size_t n) {
+    this->n = n;
+    distMatrix.assign(n * n, WeightTraits<T>::INF);
+    pathMatrix.assign(n * n, nullptr);
 }
 
 template <class T>
-bool Edge<T>::isSelected() const {
-    return this->selected;
+void AllPairsTable<T>::clear() {
+    n = 0;
+    distMatrix = {};
+    pathMatrix = {};
 }
 
 template <class T>
-bool Edge<T>::isRestricted() const {
-    return this->restricted;
+bool AllPairsTable<T>::empty() const {
+    return n == 0;
 }
 
 template <class T>
-void Edge<T>::setSelected(bool selected) {
-    this->selected = selected;
+size_t AllPairsTable<T>::size() const {
+    return n;
 }
 
 template <class T>
-void Edge<T>::setReverse(Edge<T> *reverse) {
-    this->reverse = reverse;
+size_t AllPairsTable<T>::bytes() const {
+    return distMatrix.size() * sizeof(Distance) + pathMatrix.size() * sizeof(Edge<T> *);
 }
 
+template <class T>
+typename AllPairsTable<T>::Distance AllPairsTable<T>::getDist(const Vertex<T> *from, const Vertex<T> *to) const {
+    return distMatrix[from->getIndex() * n + to->getIndex()];
+}
+
+template <class T>
+Edge<T> *AllPairsTable<T>::getPath(const Vertex<T> *from, const Vertex<T> *to) const {
+    return pathMatrix[from->getIndex() * n + to->getIndex()];
+}
+
+template <class T>
+void AllPairsTable<T>::store(size_t row, const SearchTree<T> &tree) {
+    std::copy(tree.dist.begin(), tree.dist.end(), distMatrix.begin() + row * n);
+    std::copy(tree.path.begin(), tree.path.end(), pathMatrix.begin() + row * n);
+}
+
+template <class T>
+void AllPairsTable<T>::load(size_t row, SearchTree<T> &tree) const {
+    tree.dist.assign(distMatrix.begin() + row * n, distMatrix.begin() + (row + 1) * n);
+    tree.path.assign(pathMatrix.begin() + row * n, pathMatrix.begin() + (row + 1) * n);
+}
+
+/********************** TreeCache  ****************************/
+
+template <class T>
+void TreeCache<T>::setBudget(size_t bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    limit = bytes;
+    evict();
+}
+
+template <class T>
+size_t TreeCache<T>::budget() const {
+    return limit;
+}
+
+template <class T>
+bool TreeCache<T>::enabled() const {
+    return limit != 0;
+}
+
+template <class T>
+void TreeCache<T>::clear() {
+    std::lock_guard<std::mutex> guard(lock);
+    entries.clear();
+    byKey.clear();
+    used = 0;
+}
+
+template <class T>
+bool TreeCache<T>::load(int root, bool driving, uint64_t restrictions, SearchTree<T> &tree) {
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = byKey.find({root, driving, restrictions});
+    if (it == byKey.end()) {
+        counts.misses++;
+        return false;
+    }
+    counts.hits++;
+    entries.splice(entries.begin(), entries, it->second);
+    tree.dist.assign(it->second->dist.begin(), it->second->dist.end());
+    tree.path.assign(it->second->path.begin(), it->second->path.end());
+    return true;
+}
+
+template <class T>
+void TreeCache<T>::store(int root, bool driving, uint64_t restrictions, const SearchTree<T> &tree) {
+    Entry entry{{root, driving, restrictions}, tree.dist, tree.path}; // copied before taking the lock
+    if (bytes(entry) > limit) return;
+
+    std::lock_guard<std::mutex> guard(lock);
+    auto it = byKey.find(entry.key);
+    if (it != byKey.end()) { // stored meanwhile by another thread
+        entries.splice(entries.begin(), entries, it->second);
+        return;
+    }
+    used += bytes(entry);
+    entries.push_front(std::move(entry));
+    byKey.emplace(entries.front().key, entries.begin());
+    evict();
+}
+
+template <class T>
+typename TreeCache<T>::Stats TreeCache<T>::stats() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return counts;
+}
+
+template <class T>
+size_t TreeCache<T>::size() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return entries.size();
+}
+
+template <class T>
+size_t TreeCache<T>::bytes() const {
+    std::lock_guard<std::mutex> guard(lock);
+    return used;
+}
+
+template <class T>
+size_t TreeCache<T>::KeyHash::operator()(const Key &key) const {
+    return std::hash<uint64_t>()(key.restrictions ^ (((uint64_t(uint32_t(key.root)) << 1) | key.driving) * 0x9E3779B97F4A7C15ull));
+}
+
+template <class T>
+size_t TreeCache<T>::bytes(const Entry &entry) {
+    return entry.dist.size() * sizeof(Distance) + entry.path.size() * sizeof(Edge<T> *);
+}
+
+template <class T>
+void TreeCache<T>::evict() {
+    while (used > limit) {
+        used -= bytes(entries.back());
+        byKey.erase(entries.back().key);
+        entries.pop_back();
+        counts.evictions++;
+    }
+}
 
 /********************** Graph  ****************************/
 
@@ -396,28 +865,93 @@ int Graph<T>::getNumVertex() const {
 }
 
 template <class T>
-std::vector<Vertex<T> *> Graph<T>::getVertexSet() const {
+int Graph<T>::getNumEdgeIndices() const {
+    return edgeArena.size();
+}
+
+template <class T>
+std::span<Vertex<T> * const> Graph<T>::getVertexSet() const {
     return vertexSet;
 }
 
+template <class T>
+Vertex<T> *Graph<T>::getVertex(const int index) const {
+    return vertexSet[index];
+}
+
+template <class T>
+const std::string &Graph<T>::getName(const Symbol handle) const {
+    return names.get(handle);
+}
+
+template <class T>
+SearchTree<T> &Graph<T>::getDriveTree() {
+    return driveTree;
+}
+
+template <class T>
+AllPairsTable<T> &Graph<T>::getDriveTable() {
+    return driveTable;
+}
+
+template <class T>
+AllPairsTable<T> &Graph<T>::getWalkTable() {
+    return walkTable;
+}
+
+template <class T>
+HubLabels &Graph<T>::getDriveLabels() {
+    return driveLabels;
+}
+
+template <class T>
+HubLabels &Graph<T>::getWalkLabels() {
+    return walkLabels;
+}
+
+template <class T>
+ArcFlags &Graph<T>::getDriveFlags() {
+    return driveFlags;
+}
+
+template <class T>
+ArcFlags &Graph<T>::getWalkFlags() {
+    return walkFlags;
+}
+
+template <class T>
+ParkingIndex &Graph<T>::getParkingIndex() {
+    return parkingIndex;
+}
+
+template <class T>
+TreeCache<T> &Graph<T>::getTreeCache() {
+    return treeCache;
+}
+
+template <class T>
+SearchTree<T> &Graph<T>::getWalkTree() {
+    return walkTree;
+}
+
 /*
  * Auxiliary function to find a vertex with a given content.
  */
 template <class T>
 Vertex<T> * Graph<T>::findVertex(const int id) const {
-    for (auto v : vertexSet)
-        if (v->getID() == id)
-            return v;
-    return nullptr;
+    auto it = byID.find(id);
+    return it == byID.end() ? nullptr : it->second;
 }
 
+/*
+ * Finds a vertex by code: one hash lookup in the string table, then the handle indexes byCode.
+ */
 template <class T>
-Vertex<T> * Graph<T>::findVertexCode(const std::string code) const {
-    for (auto v : vertexSet)
-        if (v->getCode() == code)
-            return v;
-
-    return nullptr;
+Vertex<T> * Graph<T>::findVertexCode(const std::string &code) const {
+    Symbol h = names.find(code);
+    if (h == StringTable::npos || h >= byCode.size())
+        return nullptr;
+    return byCode[h];
 }
 
 /*
@@ -428,7 +962,15 @@ template <class T>
 bool Graph<T>::addVertex(const std::string &location, const int id, const std::string &code, const bool parking) {
     if (findVertex(id) != nullptr)
         return false;
-    vertexSet.push_back(new Vertex<T>(location, id, code, parking));
+    Symbol c = names.intern(code);
+    Symbol l = names.intern(location);
+    auto v = vertexArena.create(l, id, c, parking, vertexSet.size());
+    vertexSet.push_back(v);
+    byID.emplace(id, v);
+    if (byCode.size() < names.size())
+        byCode.resize(names.size(), nullptr);
+    if (byCode[c] == nullptr)
+        byCode[c] = v;
     return true;
 }
 
@@ -439,6 +981,7 @@ bool Graph<T>::addVertex(const std::string &location, const int id, const std::s
  */
 template <class T>
 bool Graph<T>::removeVertex(const int id) {
+    dropDerivedAdjacency();
     for (auto it = vertexSet.begin(); it != vertexSet.end(); it++) {
         if ((*it)->getID() == id) {
             auto v = *it;
@@ -446,8 +989,13 @@ bool Graph<T>::removeVertex(const int id) {
             for (auto u : vertexSet) {
                 u->removeEdge(v->getID());
             }
-            vertexSet.erase(it);
-            delete v;
+            if (byCode[v->getCode()] == v)
+                byCode[v->getCode()] = nullptr;
+            byID.erase(id);
+            it = vertexSet.erase(it);
+            for (; it != vertexSet.end(); it++)
+                (*it)->setIndex((*it)->getIndex() - 1);
+            reindexSegments();
             return true;
         }
     }
@@ -460,12 +1008,15 @@ bool Graph<T>::removeVertex(const int id) {
  * Returns true if successful, and false if the source or destination vertex does not exist.
  */
 template <class T>
-bool Graph<T>::addEdge(const T &sourc, const T &dest, double wd, double ww) {
+bool Graph<T>::addEdge(const T &sourc, const T &dest, Weight wd, Weight ww) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return false;
-    v1->addEdge(v2, wd, ww);
+    dropDerivedAdjacency();
+    auto e = edgeArena.create(v1, v2, wd, ww, false, edgeArena.size());
+    v1->addEdge(e);
+    indexSegment(e);
     return true;
 }
 
@@ -480,44 +1031,244 @@ bool Graph<T>::removeEdge(const T &sourc, const T &dest) {
     if (srcVertex == nullptr) {
         return false;
     }
-    return srcVertex->removeEdge(dest);
+    dropDerivedAdjacency();
+    bool removed = srcVertex->removeEdge(dest);
+    if (removed)
+        reindexSegments();
+    return removed;
+}
+
+template <class T>
+std::vector<Edge<T> *> Graph<T>::findSegment(const T &sourc, const T &dest) const {
+    std::vector<Edge<T> *> res;
+    auto range = bySegment.equal_range(segmentKey(sourc, dest));
+    for (auto it = range.first; it != range.second; it++)
+        res.push_back(it->second);
+    return res;
+}
+
+template <class T>
+uint64_t Graph<T>::segmentKey(const T &sourc, const T &dest) {
+    return uint64_t(uint32_t(sourc)) << 32 | uint32_t(dest);
+}
+
+/*
+ * Registers an edge under the direction(s) it can be traversed in.
+ */
+template <class T>
+void Graph<T>::indexSegment(Edge<T> *e) {
+    bySegment.emplace(segmentKey(e->getOrig()->getID(), e->getDest()->getID()), e);
+    if (e->isBidirectional() && e->getOrig() != e->getDest())
+        bySegment.emplace(segmentKey(e->getDest()->getID(), e->getOrig()->getID()), e);
 }
 
 template <class T>
-bool Graph<T>::addBidirectionalEdge(const T &sourc, const T &dest, double wd, double ww) {
+void Graph<T>::reindexSegments() {
+    bySegment.clear();
+    for (auto v : vertexSet)
+        for (auto e : v->getAdj())
+            if (e->getOrig() == v) // each edge once
+                indexSegment(e);
+}
+
+/*
+ * Adds a bidirectional segment: a single edge, stored once and listed in the adjacency of both endpoints.
+ * Returns true if successful, and false if the source or destination vertex does not exist.
+ */
+template <class T>
+bool Graph<T>::addBidirectionalEdge(const T &sourc, const T &dest, Weight wd, Weight ww) {
     auto v1 = findVertex(sourc);
     auto v2 = findVertex(dest);
     if (v1 == nullptr || v2 == nullptr)
         return false;
-    auto e1 = v1->addEdge(v2, wd, ww);
-    auto e2 = v2->addEdge(v1, wd, ww);
-    e1->setReverse(e2);
-    e2->setReverse(e1);
+    dropDerivedAdjacency();
+    auto e = edgeArena.create(v1, v2, wd, ww, true, edgeArena.size());
+    v1->addEdge(e);
+    if (v2 != v1)
+        v2->addEdge(e);
+    indexSegment(e);
     return true;
 }
 
-inline void deleteMatrix(int **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+template <class T>
+void Graph<T>::reorderVertices(const std::vector<int> &order) {
+    // vertices: moved into a single slab, in the new order
+    Arena<Vertex<T>> vertices(vertexSet.size());
+    std::vector<Vertex<T> *> moved(vertexSet.size()); // new vertex of each old index
+    std::vector<Vertex<T> *> reordered;
+    reordered.reserve(vertexSet.size());
+    for (int i = 0; i < (int) order.size(); i++) {
+        auto v = vertices.create(std::move(*vertexSet[order[i]]));
+        v->setIndex(i);
+        moved[order[i]] = v;
+        reordered.push_back(v);
     }
+
+    // edges: rebuilt in the order they are first met, pointing to the moved vertices
+    Arena<Edge<T>> edges(edgeArena.size() > 0 ? edgeArena.size() : 1);
+    std::unordered_map<const Edge<T> *, Edge<T> *> relinked;
+    auto relink = [&](Edge<T> *&e) {
+        auto it = relinked.find(e);
+        if (it == relinked.end()) {
+            auto copy = edges.create(moved[e->orig->getIndex()], moved[e->dest->getIndex()],
+                                     e->weight_drive, e->weight_walk, e->bidirectional, edges.size());
+            copy->selected = e->selected;
+            it = relinked.emplace(e, copy).first;
+        }
+        e = it->second;
+    };
+    for (auto v : reordered) {
+        for (auto &e : v->adj) relink(e);
+        for (auto &e : v->adj_drive) relink(e);
+        for (auto &e : v->adj_walk) relink(e);
+        for (auto &e : v->incoming) relink(e);
+    }
+
+    vertexSet.swap(reordered);
+    vertexArena.swap(vertices); // the old vertices and edges are released at the end of this scope
+    edgeArena.swap(edges);
+
+    for (auto &v : byCode)
+        if (v != nullptr) v = moved[v->getIndex()];
+    for (auto &entry : byID)
+        entry.second = moved[entry.second->getIndex()];
+
+    driveTree.reset(vertexSet.size()); // their paths point to the old edges
+    walkTree.reset(vertexSet.size());
+    driveTable.clear();               // so do the tables, and their rows follow the old indices
+    walkTable.clear();
+    driveLabels.clear();              // labels are by index too
+    walkLabels.clear();
+    driveFlags.clear();               // and flags by edge index
+    walkFlags.clear();
+    parkingIndex.clear();             // and the parking lists by vertex index
+    treeCache.clear();                // and the cached trees, like the tables
+    reindexSegments();
+
+    if (!compressedDrive.empty())
+        compressAdjacency(); // neighbour indices changed
+    if (!soaDrive.empty())
+        buildSoAAdjacency(); // neighbour indices and edges changed
+    if (hasComponents())
+        labelComponents(); // labels are indexed by vertex index
+}
+
+template <class T>
+void Graph<T>::compressAdjacency() {
+    for (int metric = 0; metric < 2; metric++) {
+        std::vector<uint32_t> offsets = {0}, targets;
+        std::vector<Weight> weights;
+        for (auto v : vertexSet) {
+            for (auto e : metric == 0 ? v->getAdjDrive() : v->getAdjWalk()) {
+                targets.push_back(e->getOther(v)->getIndex());
+                weights.push_back(metric == 0 ? e->getWeightDrive() : e->getWeightWalk());
+            }
+            offsets.push_back(targets.size());
+        }
+        (metric == 0 ? compressedDrive : compressedWalk).build(offsets, targets, weights);
+    }
+}
+
+template <class T>
+void Graph<T>::dropCompressedAdjacency() {
+    compressedDrive.clear();
+    compressedWalk.clear();
+}
+
+template <class T>
+void Graph<T>::buildSoAAdjacency() {
+    for (int metric = 0; metric < 2; metric++) {
+        auto &soa = metric == 0 ? soaDrive : soaWalk;
+        soa.clear();
+        for (auto v : vertexSet) {
+            for (auto e : metric == 0 ? v->getAdjDrive() : v->getAdjWalk())
+                soa.add(e->getOther(v)->getIndex(), metric == 0 ? e->getWeightDrive() : e->getWeightWalk(), e);
+            soa.endVertex();
+        }
+    }
+}
+
+template <class T>
+void Graph<T>::dropSoAAdjacency() {
+    soaDrive.clear();
+    soaWalk.clear();
+}
+
+template <class T>
+void Graph<T>::dropDerivedAdjacency() {
+    dropCompressedAdjacency();
+    dropSoAAdjacency();
+    driveComponent.clear();
+    walkComponent.clear();
+    driveTable.clear();
+    walkTable.clear();
+    driveLabels.clear();
+    walkLabels.clear();
+    driveFlags.clear();
+    walkFlags.clear();
+    parkingIndex.clear();
+    treeCache.clear();
 }
 
-inline void deleteMatrix(double **m, int n) {
-    if (m != nullptr) {
-        for (int i = 0; i < n; i++)
-            if (m[i] != nullptr)
-                delete [] m[i];
-        delete [] m;
+template <class T>
+void Graph<T>::labelComponents() {
+    std::vector<int> parent(vertexSet.size());
+    auto find = [&](int x) {
+        while (parent[x] != x)
+            x = parent[x] = parent[parent[x]]; // path halving
+        return x;
+    };
+
+    for (int metric = 0; metric < 2; metric++) {
+        for (int i = 0; i < (int) parent.size(); i++)
+            parent[i] = i;
+        for (auto v : vertexSet) {
+            for (auto e : metric == 0 ? v->getAdjDrive() : v->getAdjWalk()) {
+                int a = find(v->getIndex()), b = find(e->getOther(v)->getIndex());
+                if (a != b) parent[std::max(a, b)] = std::min(a, b);
+            }
+        }
+
+        auto &label = metric == 0 ? driveComponent : walkComponent;
+        label.resize(parent.size());
+        for (int i = 0; i < (int) parent.size(); i++)
+            label[i] = find(i); // the smallest index of the component
     }
 }
 
 template <class T>
-Graph<T>::~Graph() {
-    deleteMatrix(distMatrix, vertexSet.size());
-    deleteMatrix(pathMatrix, vertexSet.size());
+bool Graph<T>::hasComponents() const {
+    return !driveComponent.empty();
+}
+
+template <class T>
+int Graph<T>::getDriveComponent(const Vertex<T> *v) const {
+    return driveComponent[v->getIndex()];
+}
+
+template <class T>
+int Graph<T>::getWalkComponent(const Vertex<T> *v) const {
+    return walkComponent[v->getIndex()];
+}
+
+template <class T>
+const SoAAdjacency<typename Graph<T>::Weight, Edge<T>> *Graph<T>::getSoADrive() const {
+    return soaDrive.empty() ? nullptr : &soaDrive;
+}
+
+template <class T>
+const SoAAdjacency<typename Graph<T>::Weight, Edge<T>> *Graph<T>::getSoAWalk() const {
+    return soaWalk.empty() ? nullptr : &soaWalk;
+}
+
+template <class T>
+const CompressedAdjacency<typename Graph<T>::Weight> *Graph<T>::getCompressedDrive() const {
+    return compressedDrive.empty() ? nullptr : &compressedDrive;
+}
+
+template <class T>
+const CompressedAdjacency<typename Graph<T>::Weight> *Graph<T>::getCompressedWalk() const {
+    return compressedWalk.empty() ? nullptr : &compressedWalk;
 }
 
 #endif /* DA_TP_CLASSES_GRAPH */
\ No newline at end of file
@@ -0,0 +1,159 @@
+/*
+ * HubLabels.h
+ * Hub labels for one metric (driving or walking) of a graph: every vertex keeps the distances to and from a few
+ * hub vertices, chosen so that some hub of every shortest path is in both endpoints' labels. The distance
+ * between two vertices is then a merge of two short sorted lists, with no search.
+ *
+ * Everything lives in one flat array of 32-bit words, with offsets instead of pointers, so it can be written to a
+ * file as is and mapped back (see attach):
+ *   [0] number of vertices n
+ *   [1] 1 if every label serves both ways (no directed edges), 0 otherwise
+ *   [2 .. n+2]          out-label offsets: start of the label of each vertex, in words from the array start
+ *   [n+3 .. 2n+3]       in-label offsets (only if not symmetric)
+ *   then the labels:    (hub rank, distance) pairs, by increasing hub rank
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_HUBLABELS
+#define DA_TP_CLASSES_HUBLABELS
+
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+class HubLabels {
+public:
+    using Label = std::vector<std::pair<uint32_t, uint32_t>>;   // (hub rank, distance), by increasing rank
+
+    static constexpr uint32_t INF = UINT32_MAX;
+
+    /*
+     * Flattens the labels of each vertex: (out)[v] holds the distances from v to its hubs, (in)[v] those from
+     * its hubs to v. If (symmetric), (in) is not used and the out-labels serve both ways.
+     */
+    void build(const std::vector<Label> &out, const std::vector<Label> &in, bool symmetric);
+
+    /*
+     * Reads labels laid out by build() from an external buffer (e.g. a mapped file), which must outlive them.
+     */
+    void attach(const uint32_t *words);
+    void clear();
+
+    bool empty() const;
+    size_t numEntries() const;
+    size_t bytes() const;
+    const uint32_t *data() const;   // the flat layout, bytes() long
+
+    /*
+     * Distance from the vertex of index (s) to that of index (t), or INF if there is no path.
+     */
+    uint32_t query(int s, int t) const;
+
+private:
+    std::vector<uint32_t> storage;     // owned layout (empty when attached)
+    const uint32_t *words = nullptr;   // layout in use
+
+    uint32_t numVertices() const;
+    const uint32_t *outBegin(int v) const;
+    const uint32_t *outEnd(int v) const;
+    const uint32_t *inBegin(int v) const;
+    const uint32_t *inEnd(int v) const;
+};
+
+inline void HubLabels::build(const std::vector<Label> &out, const std::vector<Label> &in, bool symmetric) {
+    const uint32_t n = out.size();
+    const uint32_t header = 2 + (n + 1) * (symmetric ? 1 : 2);
+
+    storage.assign(header, 0);
+    storage[0] = n;
+    storage[1] = symmetric;
+
+    for (int side = 0; side < (symmetric ? 1 : 2); side++) {
+        const auto &labels = side == 0 ? out : in;
+        const uint32_t offsets = 2 + side * (n + 1);
+        for (uint32_t v = 0; v < n; v++) {
+            storage[offsets + v] = storage.size();
+            for (auto [hub, dist] : labels[v]) {
+                storage.push_back(hub);
+                storage.push_back(dist);
+            }
+        }
+        storage[offsets + n] = storage.size();
+    }
+
+    storage.shrink_to_fit();
+    words = storage.data();
+}
+
+inline void HubLabels::attach(const uint32_t *words) {
+    storage.clear();
+    this->words = words;
+}
+
+inline void HubLabels::clear() {
+    storage = {};
+    words = nullptr;
+}
+
+inline bool HubLabels::empty() const {
+    return words == nullptr;
+}
+
+inline size_t HubLabels::numEntries() const {
+    if (empty()) return 0;
+    const uint32_t header = 2 + (numVertices() + 1) * (words[1] ? 1 : 2);
+    return (bytes() / sizeof(uint32_t) - header) / 2;
+}
+
+inline size_t HubLabels::bytes() const {
+    if (empty()) return 0;
+    const uint32_t *end = words[1] ? outEnd(numVertices() - 1) : inEnd(numVertices() - 1);
+    return (end - words) * sizeof(uint32_t);
+}
+
+inline const uint32_t *HubLabels::data() const {
+    return words;
+}
+
+inline uint32_t HubLabels::numVertices() const {
+    return words[0];
+}
+
+inline const uint32_t *HubLabels::outBegin(int v) const {
+    return words + words[2 + v];
+}
+
+inline const uint32_t *HubLabels::outEnd(int v) const {
+    return words + words[2 + v + 1];
+}
+
+inline const uint32_t *HubLabels::inBegin(int v) const {
+    return words[1] ? outBegin(v) : words + words[2 + numVertices() + 1 + v];
+}
+
+inline const uint32_t *HubLabels::inEnd(int v) const {
+    return words[1] ? outEnd(v) : words + words[2 + numVertices() + 1 + v + 1];
+}
+
+inline uint32_t HubLabels::query(int s, int t) const {
+    const uint32_t *a = outBegin(s), *aEnd = outEnd(s);
+    const uint32_t *b = inBegin(t), *bEnd = inEnd(t);
+    uint32_t best = INF;
+
+    while (a != aEnd && b != bEnd) { // merge by hub rank
+        if (a[0] == b[0]) {
+            best = std::min(best, a[1] + b[1]);
+            a += 2;
+            b += 2;
+        } else if (a[0] < b[0]) {
+            a += 2;
+        } else {
+            b += 2;
+        }
+    }
+    return best;
+}
+
+#endif /* DA_TP_CLASSES_HUBLABELS */
@@ -0,0 +1,144 @@
+/*
+ * IndexedPriorityQueue.h
+ * A mutable priority queue of vertex indices, keyed by an external distance array.
+ *
+ * Same binary heap as MutablePriorityQueue (João Pascoal Faria, 2018), but the heap positions live
+ * in the queue instead of in the vertices, so several searches can run over the same graph.
+ *
+ * Adapted by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_INDEXEDPRIORITYQUEUE
+#define DA_TP_CLASSES_INDEXEDPRIORITYQUEUE
+
+#include <vector>
+
+/**
+ * K must have operator< defined. Keys are read from (keys) whenever the heap is reordered,
+ * so a decrease of keys[i] must be followed by decreaseKey(i).
+ */
+
+template <class K>
+class IndexedPriorityQueue {
+    const std::vector<K> *keys;
+    std::vector<int> H;        // heap of indices, starting at position 1
+    std::vector<unsigned> pos; // position of each index in H (0 if not queued)
+    void heapifyUp(unsigned i);
+    void heapifyDown(unsigned i);
+    inline void set(unsigned i, int x);
+    inline bool less(int a, int b) const;
+public:
+    IndexedPriorityQueue();
+    explicit IndexedPriorityQueue(const std::vector<K> &keys);
+    /*
+     * Empties the queue and binds it to (keys), keeping the memory already reserved.
+     */
+    void reset(const std::vector<K> &keys);
+    void insert(int x);
+    int extractMin();
+    void decreaseKey(int x);
+    bool contains(int x) const;
+    bool empty() const;
+    /*
+     * Returns the index at heap position (i), 1 being the minimum, or -1 if the heap is smaller.
+     * Only the minimum is guaranteed to be extracted next; the others are likely to follow soon.
+     */
+    int peek(unsigned i) const;
+};
+
+template <class K>
+IndexedPriorityQueue<K>::IndexedPriorityQueue(): keys(nullptr) {
+    H.push_back(-1);
+}
+
+template <class K>
+IndexedPriorityQueue<K>::IndexedPriorityQueue(const std::vector<K> &keys) {
+    reset(keys);
+}
+
+template <class K>
+void IndexedPriorityQueue<K>::reset(const std::vector<K> &keys) {
+    this->keys = &keys;
+    pos.assign(keys.size(), 0);
+    H.clear();
+    H.reserve(keys.size() + 1);
+    H.push_back(-1);
+    // indices will be used starting in 1
+    // to facilitate parent/child calculations
+}
+
+template <class K>
+bool IndexedPriorityQueue<K>::empty() const {
+    return H.size() == 1;
+}
+
+template <class K>
+bool IndexedPriorityQueue<K>::contains(const int x) const {
+    return pos[x] != 0;
+}
+
+template <class K>
+int IndexedPriorityQueue<K>::peek(const unsigned i) const {
+    return i < H.size() ? H[i] : -1;
+}
+
+template <class K>
+int IndexedPriorityQueue<K>::extractMin() {
+    auto x = H[1];
+    H[1] = H.back();
+    H.pop_back();
+    if (H.size() > 1) heapifyDown(1);
+    pos[x] = 0;
+    return x;
+}
+
+template <class K>
+void IndexedPriorityQueue<K>::insert(const int x) {
+    H.push_back(x);
+    heapifyUp(H.size() - 1);
+}
+
+template <class K>
+void IndexedPriorityQueue<K>::decreaseKey(const int x) {
+    heapifyUp(pos[x]);
+}
+
+template <class K>
+bool IndexedPriorityQueue<K>::less(const int a, const int b) const {
+    return (*keys)[a] < (*keys)[b];
+}
+
+template <class K>
+void IndexedPriorityQueue<K>::heapifyUp(unsigned i) {
+    auto x = H[i];
+    while (i > 1 && less(x, H[i / 2])) {
+        set(i, H[i / 2]);
+        i = i / 2;
+    }
+    set(i, x);
+}
+
+template <class K>
+void IndexedPriorityQueue<K>::heapifyDown(unsigned i) {
+    auto x = H[i];
+    while (true) {
+        unsigned k = i * 2;
+        if (k >= H.size())
+            break;
+        if (k + 1 < H.size() && less(H[k + 1], H[k]))
+            ++k; // right child of i
+        if (!less(H[k], x))
+            break;
+        set(i, H[k]);
+        i = k;
+    }
+    set(i, x);
+}
+
+template <class K>
+void IndexedPriorityQueue<K>::set(const unsigned i, const int x) {
+    H[i] = x;
+    pos[x] = i;
+}
+
+#endif /* DA_TP_CLASSES_INDEXEDPRIORITYQUEUE */
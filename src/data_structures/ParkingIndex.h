@@ -0,0 +1,85 @@
+/*
+ * ParkingIndex.h
+ * Parking vertices within a walking budget of every vertex: for each vertex, the parking vertices a walking search
+ * from it reaches within the budget, with their walking times, nearest first. An eco query reads the candidates of
+ * its destination instead of searching and scanning every vertex for them.
+ *
+ * The lists are stored back to back in one array, with the start of each vertex's list in another.
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_PARKINGINDEX
+#define DA_TP_CLASSES_PARKINGINDEX
+
+#include <vector>
+#include <span>
+#include <cstdint>
+
+class ParkingIndex {
+public:
+    struct Entry {
+        int parking;     // index of the parking vertex
+        uint32_t time;   // walking time to it
+    };
+
+    /*
+     * Flattens the lists of each vertex (by index), which must be sorted by time and within (budget).
+     */
+    void build(const std::vector<std::vector<Entry>> &lists, uint32_t budget);
+    void clear();
+
+    bool empty() const;
+    uint32_t budget() const;   // longest walk the lists cover
+    size_t numEntries() const;
+    size_t bytes() const;
+
+    /*
+     * Parking vertices within the budget of the vertex of that index, by increasing walking time.
+     */
+    std::span<const Entry> candidates(int vertex) const;
+
+private:
+    std::vector<uint32_t> offsets;   // start of each vertex's list in entries, and the end of the last
+    std::vector<Entry> entries;
+    uint32_t limit = 0;
+};
+
+inline void ParkingIndex::build(const std::vector<std::vector<Entry>> &lists, const uint32_t budget) {
+    offsets.assign(1, 0);
+    entries.clear();
+    for (const auto &list : lists) {
+        entries.insert(entries.end(), list.begin(), list.end());
+        offsets.push_back(entries.size());
+    }
+    entries.shrink_to_fit();
+    limit = budget;
+}
+
+inline void ParkingIndex::clear() {
+    offsets = {};
+    entries = {};
+    limit = 0;
+}
+
+inline bool ParkingIndex::empty() const {
+    return offsets.empty();
+}
+
+inline uint32_t ParkingIndex::budget() const {
+    return limit;
+}
+
+inline size_t ParkingIndex::numEntries() const {
+    return entries.size();
+}
+
+inline size_t ParkingIndex::bytes() const {
+    return offsets.size() * sizeof(uint32_t) + entries.size() * sizeof(Entry);
+}
+
+inline std::span<const ParkingIndex::Entry> ParkingIndex::candidates(const int vertex) const {
+    return std::span<const Entry>(entries).subspan(offsets[vertex], offsets[vertex + 1] - offsets[vertex]);
+}
+
+#endif /* DA_TP_CLASSES_PARKINGINDEX */
@@ -0,0 +1,140 @@
+/*
+ * Restrictions.h
+ * Per-query restriction masks: which vertices and edges a search may not use.
+ *
+ * Vertices and edges are addressed by their index in the graph (Vertex::getIndex, Edge::getIndex), so a query
+ * never writes to the graph it searches. The indices that were set are remembered, so clearing the masks
+ * costs as much as setting them, not as much as the graph.
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_RESTRICTIONS
+#define DA_TP_CLASSES_RESTRICTIONS
+
+#include <vector>
+#include <cstdint>
+
+class Restrictions {
+public:
+    Restrictions() = default;
+
+    /*
+     * Sizes the masks for (numVertices) vertex indices and (numEdges) edge indices, with nothing restricted.
+     * Indices outside the masks are never restricted, so an empty Restrictions allows everything.
+     */
+    Restrictions(size_t numVertices, size_t numEdges);
+
+    void restrictVertex(int index);
+    void restrictEdge(int index);
+    void allowVertex(int index);
+    void allowEdge(int index);
+
+    bool isVertexRestricted(int index) const;
+    bool isEdgeRestricted(int index) const;
+    bool empty() const; // nothing was restricted since the last clear()
+
+    /*
+     * Hash of the restricted vertices and edges, whatever order they were restricted in (0 if none is),
+     * to tell apart the searches of different restriction sets.
+     */
+    uint64_t hash() const;
+
+    /*
+     * Lifts every restriction, in time proportional to the number of restrict calls since the last clear().
+     */
+    void clear();
+
+    /*
+     * An empty mask, for searches without restrictions.
+     */
+    static const Restrictions &none();
+
+private:
+    std::vector<uint64_t> vertexBits;
+    std::vector<uint64_t> edgeBits;
+    std::vector<int> vertexSet;  // indices restricted since the last clear (may repeat)
+    std::vector<int> edgeSet;
+
+    static void set(std::vector<uint64_t> &bits, int index);
+    static void reset(std::vector<uint64_t> &bits, int index);
+    static bool test(const std::vector<uint64_t> &bits, int index);
+    static uint64_t mix(uint64_t x);
+};
+
+inline Restrictions::Restrictions(const size_t numVertices, const size_t numEdges):
+    vertexBits((numVertices + 63) / 64, 0), edgeBits((numEdges + 63) / 64, 0) {}
+
+inline void Restrictions::set(std::vector<uint64_t> &bits, const int index) {
+    if (size_t(index >> 6) >= bits.size())
+        bits.resize((index >> 6) + 1, 0);
+    bits[index >> 6] |= uint64_t(1) << (index & 63);
+}
+
+inline void Restrictions::reset(std::vector<uint64_t> &bits, const int index) {
+    if (size_t(index >> 6) < bits.size())
+        bits[index >> 6] &= ~(uint64_t(1) << (index & 63));
+}
+
+inline bool Restrictions::test(const std::vector<uint64_t> &bits, const int index) {
+    return size_t(index >> 6) < bits.size() && (bits[index >> 6] >> (index & 63) & 1);
+}
+
+inline void Restrictions::restrictVertex(const int index) {
+    set(vertexBits, index);
+    vertexSet.push_back(index);
+}
+
+inline void Restrictions::restrictEdge(const int index) {
+    set(edgeBits, index);
+    edgeSet.push_back(index);
+}
+
+inline void Restrictions::allowVertex(const int index) {
+    reset(vertexBits, index);
+}
+
+inline void Restrictions::allowEdge(const int index) {
+    reset(edgeBits, index);
+}
+
+inline bool Restrictions::isVertexRestricted(const int index) const {
+    return test(vertexBits, index);
+}
+
+inline bool Restrictions::isEdgeRestricted(const int index) const {
+    return test(edgeBits, index);
+}
+
+inline bool Restrictions::empty() const {
+    return vertexSet.empty() && edgeSet.empty();
+}
+
+inline uint64_t Restrictions::mix(uint64_t x) { // splitmix64 finalizer
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+inline uint64_t Restrictions::hash() const {
+    uint64_t h = 0; // sum of the mixed non-zero words and their positions, so trailing zero words do not count
+    for (size_t i = 0; i < vertexBits.size(); i++)
+        if (vertexBits[i] != 0) h += mix(vertexBits[i] ^ mix(2 * i));
+    for (size_t i = 0; i < edgeBits.size(); i++)
+        if (edgeBits[i] != 0) h += mix(edgeBits[i] ^ mix(2 * i + 1));
+    return h;
+}
+
+inline void Restrictions::clear() {
+    for (int i : vertexSet) reset(vertexBits, i);
+    for (int i : edgeSet) reset(edgeBits, i);
+    vertexSet.clear();
+    edgeSet.clear();
+}
+
+inline const Restrictions &Restrictions::none() {
+    static const Restrictions empty;
+    return empty;
+}
+
+#endif /* DA_TP_CLASSES_RESTRICTIONS */
@@ -0,0 +1,107 @@
+/*
+ * SoAAdjacency.h
+ * Structure-of-arrays adjacency for one metric (driving or walking) of a graph.
+ *
+ * The entries of vertex u are [begin(u), end(u)) in three parallel arrays: neighbour index, weight and edge.
+ * A relaxation kernel can then read a whole block of targets and weights without touching the Edge objects,
+ * which are only needed once an entry improves a distance.
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_SOAADJACENCY
+#define DA_TP_CLASSES_SOAADJACENCY
+
+#include <vector>
+#include <cstdint>
+
+template <class W, class E>
+class SoAAdjacency {
+public:
+    /*
+     * Builds the layout vertex by vertex, in index order: add() the entries of a vertex, then endVertex().
+     */
+    void add(int32_t target, W weight, E *edge);
+    void endVertex();
+    void clear();
+
+    bool empty() const;
+    size_t numEntries() const;
+    size_t bytes() const;
+
+    uint32_t begin(int u) const;
+    uint32_t end(int u) const;
+    const int32_t *targets() const;
+    const W *weights() const;
+    E *edge(uint32_t entry) const;
+
+private:
+    std::vector<uint32_t> offsets;  // V+1 entries
+    std::vector<int32_t> target;
+    std::vector<W> weight;
+    std::vector<E *> edges;
+};
+
+template <class W, class E>
+void SoAAdjacency<W, E>::clear() {
+    offsets.clear();
+    target.clear();
+    weight.clear();
+    edges.clear();
+}
+
+template <class W, class E>
+void SoAAdjacency<W, E>::add(const int32_t t, const W w, E *e) {
+    target.push_back(t);
+    weight.push_back(w);
+    edges.push_back(e);
+}
+
+template <class W, class E>
+void SoAAdjacency<W, E>::endVertex() {
+    if (offsets.empty())
+        offsets.push_back(0);
+    offsets.push_back(target.size());
+}
+
+template <class W, class E>
+bool SoAAdjacency<W, E>::empty() const {
+    return offsets.empty();
+}
+
+template <class W, class E>
+size_t SoAAdjacency<W, E>::numEntries() const {
+    return target.size();
+}
+
+template <class W, class E>
+size_t SoAAdjacency<W, E>::bytes() const {
+    return offsets.size() * sizeof(uint32_t) + target.size() * (sizeof(int32_t) + sizeof(W) + sizeof(E *));
+}
+
+template <class W, class E>
+uint32_t SoAAdjacency<W, E>::begin(const int u) const {
+    return offsets[u];
+}
+
+template <class W, class E>
+uint32_t SoAAdjacency<W, E>::end(const int u) const {
+    return offsets[u + 1];
+}
+
+template <class W, class E>
+const int32_t *SoAAdjacency<W, E>::targets() const {
+    return target.data();
+}
+
+template <class W, class E>
+const W *SoAAdjacency<W, E>::weights() const {
+    return weight.data();
+}
+
+template <class W, class E>
+E *SoAAdjacency<W, E>::edge(const uint32_t entry) const {
+    return edges[entry];
+}
+
+#endif /* DA_TP_CLASSES_SOAADJACENCY */
@@ -0,0 +1,72 @@
+/*
+ * StringTable.h
+ * A simple string interning table: every distinct string is stored once and referred to by an integer handle.
+ *
+ * Used by Graph to keep location names and codes out of the vertices, so that comparing two codes
+ * is an integer comparison.
+ *
+ * Created by T01_G07 (2025)
+ */
+
+#ifndef DA_TP_CLASSES_STRINGTABLE
+#define DA_TP_CLASSES_STRINGTABLE
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <cstdint>
+
+using Symbol = uint32_t;
+
+class StringTable {
+public:
+    static constexpr Symbol npos = UINT32_MAX;
+
+    StringTable() = default;
+    StringTable(const StringTable &) = delete;
+    StringTable &operator=(const StringTable &) = delete;
+
+    /*
+     * Returns the handle of (s), adding it to the table if it was not there yet.
+     */
+    Symbol intern(const std::string &s);
+
+    /*
+     * Returns the handle of (s), or npos if it was never interned.
+     */
+    Symbol find(std::string_view s) const;
+
+    const std::string &get(Symbol h) const;
+    size_t size() const;
+
+private:
+    std::deque<std::string> strings; // deque: references stay valid as it grows
+    std::unordered_map<std::string_view, Symbol> index;
+};
+
+inline Symbol StringTable::intern(const std::string &s) {
+    auto it = index.find(s);
+    if (it != index.end())
+        return it->second;
+
+    Symbol h = strings.size();
+    strings.push_back(s);
+    index.emplace(strings.back(), h);
+    return h;
+}
+
+inline Symbol StringTable::find(const std::string_view s) const {
+    auto it = index.find(s);
+    return it == index.end() ? npos : it->second;
+}
+
+inline const std::string &StringTable::get(const Symbol h) const {
+    return strings[h];
+}
+
+inline size_t StringTable::size() const {
+    return strings.size();
+}
+
+#endif /* DA_TP_CLASSES_STRINGTABLE */
@@ -1,26 +1,94 @@
 #ifndef ALGORITHMS_H
 #define ALGORITHMS_H
 
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+
 #include "../data_structures/Graph.h"
+#include "../data_structures/Restrictions.h"
+
+// Weight types of the integer-minute graph used by the program
+using Weight = WeightTraits<int>::Weight;
+using Distance = WeightTraits<int>::Distance;
+constexpr Distance INF = WeightTraits<int>::INF;
+
+/**
+ * @brief Vertices a one-to-many search has to settle before it can stop (see makeTargets).
+ */
+struct SearchTargets {
+    std::vector<bool> marked;   ///< Whether the vertex of each index is a target.
+    int count = 0;              ///< Number of distinct targets.
+    int region = -1;            ///< Arc-flag region of every target, if the graph has flags and they share one.
+    std::vector<Distance> exitCost;   ///< If not empty, the cost of going on from each target, by vertex index.
+    Distance minExitCost = 0;         ///< Smallest exit cost of a target.
+};
 
 // Edge Relaxation  ----------------------------------------------------------------------------------------------------
 
 /**
  * @brief Relaxes an edge for driving, updating the destination vertex's driving distance if a shorter path is found.
  *
+ * @param tree The driving search state to update.
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
  * @param edge The edge to relax.
  * @return true if the relaxation was successful (i.e., a shorter path was found), false otherwise.
  */
-bool driving_relax(Edge<int> *edge);
+bool driving_relax(SearchTree<int> &tree, const Restrictions &restrictions, Vertex<int> *u, Edge<int> *edge);
 
 
 /**
  * @brief Relaxes an edge for walking, updating the destination vertex's walking distance if a shorter path is found.
  *
+ * @param tree The walking search state to update.
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
  * @param edge The edge to relax.
  * @return true if the relaxation was successful (i.e., a shorter path was found), false otherwise.
  */
-bool walking_relax(Edge<int> *edge);
+bool walking_relax(SearchTree<int> &tree, const Restrictions &restrictions, Vertex<int> *u, Edge<int> *edge);
+
+// Edge lookup for compressed adjacency --------------------------------------------------------------------------------
+
+/**
+ * @brief Finds the unrestricted driving edge from u to v with the given weight, as decoded from a compressed adjacency.
+ *
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
+ * @param v The vertex the edge leads to.
+ * @param w The driving weight of the edge.
+ * @return The edge, or nullptr if all such edges are restricted.
+ */
+Edge<int> *resolveDriveEdge(const Restrictions &restrictions, Vertex<int> *u, const Vertex<int> *v, Weight w);
+
+/**
+ * @brief Finds the unrestricted walking edge from u to v with the given weight, as decoded from a compressed adjacency.
+ *
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
+ * @param v The vertex the edge leads to.
+ * @param w The walking weight of the edge.
+ * @return The edge, or nullptr if all such edges are restricted.
+ */
+Edge<int> *resolveWalkEdge(const Restrictions &restrictions, Vertex<int> *u, const Vertex<int> *v, Weight w);
+
+// Prefetching ---------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Turns the search prefetches on or off at runtime (to compare both in one run).
+ *
+ * They are only compiled in with SEARCH_PREFETCH (CMake option of the same name, off by default).
+ *
+ * @param enabled Whether the searches should prefetch.
+ * @return false if the prefetches were not compiled in.
+ */
+bool setSearchPrefetch(bool enabled);
 
 // Dijkstra for Driving ------------------------------------------------------------------------------------------------
 
@@ -29,8 +97,27 @@ bool walking_relax(Edge<int> *edge);
  *
  * @param g The graph on which to execute the algorithm.
  * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * Results are left in the graph's driving SearchTree.
+ */
+void driving_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions = Restrictions::none());
+
+/**
+ * @brief Executes Dijkstra's algorithm for driving into the given search tree instead of the graph's.
+ *
+ * The graph is only read, so searches into different trees can run concurrently.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param tree The search tree that receives the results.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param targets If given, the search stops as soon as all of them are settled (their distances and paths are final,
+ * the other vertices' may not be). With exit costs, it also stops once no target left can cost less, exit included,
+ * than the cheapest settled one: the unsettled targets' distances are then only upper bounds, too long to matter.
+ * If they share an arc-flag region and nothing is restricted, edges not flagged for it are skipped.
  */
-void driving_dijkstra(Graph<int> *g, const int &origin);
+void driving_dijkstra(Graph<int> *g, SearchTree<int> &tree, const int &origin, const Restrictions &restrictions = Restrictions::none(),
+                     const SearchTargets *targets = nullptr);
 
 // Dijkstra for Walking ------------------------------------------------------------------------------------------------
 
@@ -39,18 +126,395 @@ void driving_dijkstra(Graph<int> *g, const int &origin);
  *
  * @param g The graph on which to execute the algorithm.
  * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * Results are left in the graph's walking SearchTree.
+ */
+void walking_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions = Restrictions::none());
+
+/**
+ * @brief Executes Dijkstra's algorithm for walking into the given search tree instead of the graph's.
+ *
+ * The graph is only read, so searches into different trees can run concurrently.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param tree The search tree that receives the results.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param targets If given, the search stops as soon as all of them are settled (their distances and paths are final,
+ * the other vertices' may not be). With exit costs, it also stops once no target left can cost less, exit included,
+ * than the cheapest settled one: the unsettled targets' distances are then only upper bounds, too long to matter.
+ * If they share an arc-flag region and nothing is restricted, edges not flagged for it are skipped.
  */
-void walking_dijkstra(Graph<int> *g, const int &origin);
+void walking_dijkstra(Graph<int> *g, SearchTree<int> &tree, const int &origin, const Restrictions &restrictions = Restrictions::none(),
+                     const SearchTargets *targets = nullptr);
+
+// Parallel Searches ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Threads kept for running batches of searches, each with a driving and a walking SearchTree of its own.
+ *
+ * The threads are started by the first run and live as long as the pool, so a caller that runs many batches (one
+ * per round of an algorithm) pays for starting them, and for sizing their trees, once. The calling thread takes part
+ * in every run as the pool's first thread.
+ */
+class SearchPool {
+public:
+    using Search = std::function<void(int, SearchTree<int> &, SearchTree<int> &)>;
+
+    /**
+     * @brief Makes a pool of (threads) threads (0 for one per hardware thread), the caller's included.
+     */
+    explicit SearchPool(unsigned threads = 0);
+    ~SearchPool();
+
+    SearchPool(const SearchPool &) = delete;
+    SearchPool &operator=(const SearchPool &) = delete;
+
+    /**
+     * @brief Runs search(i, drive, walk) for every i in [0, count) over the pool's threads, and returns when all are done.
+     *
+     * Calls are handed out one at a time, so uneven searches still balance; drive and walk are the trees of the
+     * thread running the call, reused by all its calls of every run. The graph may only be read.
+     *
+     * @param count The number of calls.
+     * @param search The work of one call; calls run concurrently, so it may only write state of its own i.
+     */
+    void run(int count, const Search &search);
+
+private:
+    struct Trees {
+        SearchTree<int> drive, walk;
+    };
+
+    std::vector<Trees> trees;           // of each thread, the caller's first
+    std::vector<std::thread> workers;   // every thread but the caller
+
+    std::mutex lock;
+    std::condition_variable changed;
+    const Search *search = nullptr;     // of the current run
+    int count = 0;                      // calls of the current run
+    std::atomic<int> next = 0;          // next call to hand out
+    unsigned round = 0;                 // runs started, so that a worker knows a new one from the last
+    unsigned busy = 0;                  // workers still on the current run
+    bool stop = false;
+
+    void work(unsigned t);
+    void loop(unsigned t);
+};
+
+/**
+ * @brief Runs search(i, drive, walk) for every i in [0, count) over (threads) threads.
+ *
+ * A one-off SearchPool: each thread owns a driving and a walking SearchTree, reused by all its calls; the graph is
+ * only read. Callers that run searches in rounds should keep a SearchPool across them instead.
+ *
+ * @param count The number of calls.
+ * @param threads The number of threads (0 for one per hardware thread).
+ * @param search The work of one call; calls run concurrently, so it may only write state of its own i.
+ */
+template <class Search>
+void parallelSearches(int count, unsigned threads, Search search) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = std::min<unsigned>(threads, std::max(count, 1));
+
+    SearchPool pool(threads);
+    pool.run(count, search);
+}
+
+// Bounded Searches ----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Settles every vertex within a budget of an origin, by driving or walking, and expands nothing further.
+ *
+ * Unlike driving_dijkstra and walking_dijkstra, it only touches the vertices it reaches: the distances live in a
+ * per-thread scratch array that is reset vertex by vertex, so small budgets stay cheap on large graphs, and calls on
+ * different threads may run concurrently.
+ *
+ * @param g The graph on which to execute the search.
+ * @param driving Whether to search the driving (true) or the walking (false) metric.
+ * @param origin The vertex to start from.
+ * @param budget The largest time a settled vertex may have.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @return Every settled vertex with its time, by increasing time.
+ */
+std::vector<std::pair<Vertex<int>*, Distance>> boundedSearch(Graph<int> *g, bool driving, Vertex<int> *origin, Distance budget,
+                                                           const Restrictions &restrictions = Restrictions::none());
+
+// Cached Searches -----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Fills the graph's driving tree with a complete search from the origin, loaded from the graph's tree cache
+ * if it holds the tree of that origin and restrictions; otherwise the search runs and its tree is cached.
+ *
+ * Without a cache budget, this is driving_dijkstra.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ */
+void cached_driving_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions = Restrictions::none());
+
+/**
+ * @brief Fills the graph's walking tree with a complete search from the origin (the destination of an eco query),
+ * loaded from the graph's tree cache if it holds the tree of that origin and restrictions; otherwise the search runs
+ * and its tree is cached.
+ *
+ * Without a cache budget, this is walking_dijkstra.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ */
+void cached_walking_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions = Restrictions::none());
+
+// Concurrent Driving and Walking Searches -----------------------------------------------------------------------------
+
+/**
+ * @brief Fills the graph's driving tree from one origin and its walking tree from another, running both searches at
+ * once (the walking one on a worker thread kept between calls) when the hardware has more than one thread.
+ *
+ * The two searches only share the graph, which they read, so their results are the same as run one after the other.
+ * Complete searches (without targets) go through the graph's tree cache.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param driveOrigin The ID of the origin of the driving search.
+ * @param driveRestrictions The vertices and edges the driving search may not use.
+ * @param walkOrigin The ID of the origin of the walking search.
+ * @param walkRestrictions The vertices and edges the walking search may not use.
+ * @param targets If given, both searches stop as soon as all of them are settled.
+ */
+void driving_walking_dijkstra(Graph<int> *g, const int &driveOrigin, const Restrictions &driveRestrictions,
+                              const int &walkOrigin, const Restrictions &walkRestrictions, const SearchTargets *targets = nullptr);
+
+// Parallel Delta-stepping ---------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes the driving distances from the origin to every vertex with parallel delta-stepping.
+ *
+ * Vertices are processed a bucket of width delta (the mean driving weight, in minutes) at a time: the edges up to
+ * delta long are relaxed by all threads until the bucket stops changing, then the longer ones once. Distances are
+ * the same as driving_dijkstra's; no paths are kept, since equal-cost ties may be broken differently.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param threads The number of threads (0 for one per hardware thread).
+ * @return The distance to each vertex, by index (INF if unreachable).
+ */
+std::vector<Distance> driving_delta_stepping(Graph<int> *g, const int &origin, const Restrictions &restrictions = Restrictions::none(), unsigned threads = 0);
+
+/**
+ * @brief Computes the walking distances from the origin to every vertex with parallel delta-stepping.
+ *
+ * Vertices are processed a bucket of width delta (the mean walking weight, in minutes) at a time: the edges up to
+ * delta long are relaxed by all threads until the bucket stops changing, then the longer ones once. Distances are
+ * the same as walking_dijkstra's; no paths are kept, since equal-cost ties may be broken differently.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param threads The number of threads (0 for one per hardware thread).
+ * @return The distance to each vertex, by index (INF if unreachable).
+ */
+std::vector<Distance> walking_delta_stepping(Graph<int> *g, const int &origin, const Restrictions &restrictions = Restrictions::none(), unsigned threads = 0);
+
+/**
+ * @brief Chooses which graphs get delta-stepping for full-tree searches (see useDeltaStepping).
+ *
+ * @param minVertices The smallest graph, in vertices, to use it on (0: always; INT_MAX: never).
+ */
+void setDeltaSteppingThreshold(int minVertices);
+
+/**
+ * @brief Tells whether full-tree searches on this graph should use delta-stepping: the graph is large enough
+ * (100000 vertices by default, see setDeltaSteppingThreshold) and there is more than one hardware thread.
+ *
+ * @param g The graph to search.
+ * @return true if delta-stepping should be used.
+ */
+bool useDeltaStepping(Graph<int> *g);
+
+// All-pairs Tables ----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Fills the graph's all-pairs driving and walking tables with one search per vertex and metric.
+ *
+ * The searches are spread over (threads) threads, each with its own search trees, writing disjoint rows.
+ * Running the same Dijkstra as the single-source queries keeps their paths, ties included.
+ *
+ * @param g The graph to index.
+ * @param threads The number of threads (0 for one per hardware thread).
+ */
+void computeAllPairs(Graph<int> *g, unsigned threads);
+
+/**
+ * @brief Retrieves the shortest path from the origin to the destination vertex from an all-pairs table,
+ * in time proportional to its length.
+ *
+ * @param table The all-pairs table of the metric.
+ * @param origin The origin vertex.
+ * @param dest The destination vertex.
+ * @return A vector of vertices representing the shortest path (only the destination if there is none).
+ */
+std::vector<Vertex<int>*> getPathTable(const AllPairsTable<int> &table, Vertex<int> *origin, Vertex<int> *dest);
+
+// Hub Labels ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the graph's driving and walking hub labels by pruned landmark labelling.
+ *
+ * Vertices become hubs by decreasing degree. The search from each hub skips (and does not expand) the vertices
+ * whose distance the labels built so far already give, so the labels stay small. Segments that can only be
+ * traversed one way need separate labels towards and from the hubs; without them, one label serves both ways.
+ *
+ * @param g The graph to index.
+ */
+void computeHubLabels(Graph<int> *g);
+
+// Arc Flags -----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the graph's driving and walking arc flags for a partition of its vertices.
+ *
+ * An edge gets the flag of a region if both its ends are in it, or if it starts a shortest path to a vertex of the
+ * region entered from outside it: one backward search per such boundary vertex, spread over the hardware threads.
+ * Every shortest path into a region then only uses edges flagged for it.
+ *
+ * @param g The graph to index.
+ * @param regionOf The region of each vertex, by index (see partitionRegions).
+ * @param numRegions The number of regions (at most ArcFlags::MAX_REGIONS).
+ */
+void computeArcFlags(Graph<int> *g, const std::vector<int> &regionOf, int numRegions);
+
+// Parking Index -------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the graph's parking index: the parking vertices within (budget) minutes of walk of every vertex.
+ *
+ * One bounded search runs backwards from every parking vertex at once: its entries are (time, parking vertex, vertex)
+ * triples, each vertex may be settled once per parking vertex, and nothing past the budget is queued. The triples
+ * are settled by increasing time, so each vertex's list comes out nearest first.
+ *
+ * @param g The graph to index.
+ * @param budget The longest walk, in minutes, the lists cover.
+ */
+void computeParkingIndex(Graph<int> *g, Distance budget);
 
 // Auxiliary Function to set up for Dijkstra execution -----------------------------------------------------------------
 
 /**
- * @brief Resets the graph's vertices and edges to their initial state, allowing Dijkstra's algorithm to be re-run.
+ * @brief Resets the graph's search trees, allowing Dijkstra's algorithm to be re-run.
+ *
+ * Restrictions are not part of the graph (see Restrictions), so there is nothing else to undo.
  *
  * @param g The graph to reset.
  */
 void setup(Graph<int> *g);
 
+// Reachability Prechecks ----------------------------------------------------------------------------------------------
+
+/**
+ * @brief Tells, in O(1), whether (to) may be reachable from (from) by driving, using the graph's component labels.
+ *
+ * @param g The graph containing the vertices.
+ * @param from The origin vertex.
+ * @param to The destination vertex.
+ * @return false only if they are in different driving components (true if the graph has no labels).
+ */
+bool mayDrive(Graph<int> *g, const Vertex<int> *from, const Vertex<int> *to);
+
+/**
+ * @brief Tells, in O(1), whether (to) may be reachable from (from) by walking, using the graph's component labels.
+ *
+ * @param g The graph containing the vertices.
+ * @param from The origin vertex.
+ * @param to The destination vertex.
+ * @return false only if they are in different walking components (true if the graph has no labels).
+ */
+bool mayWalk(Graph<int> *g, const Vertex<int> *from, const Vertex<int> *to);
+
+// Query Restrictions --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the restriction masks of a query: the vertices to avoid, and the edges of the segments to avoid.
+ *
+ * Each segment (u,v) restricts the edges that can be traversed from u to v (a bidirectional segment is then
+ * restricted both ways), found with one hash lookup.
+ *
+ * @param g The graph that will be searched.
+ * @param avoid_nodes The IDs of the vertices to avoid.
+ * @param avoid_edges The segments to avoid, as pairs of vertex IDs.
+ * @return The restriction masks, sized for the graph.
+ */
+Restrictions makeRestrictions(Graph<int> *g, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges);
+
+/**
+ * @brief Marks the vertices a one-to-many search has to settle before it can stop.
+ *
+ * If the graph has arc flags and all the targets are in one region, the search may be pruned to that region.
+ *
+ * @param g The graph that will be searched.
+ * @param ids The IDs of the targets (unknown IDs are ignored, repeated ones counted once).
+ * @return The targets, sized for the graph.
+ */
+SearchTargets makeTargets(Graph<int> *g, const std::vector<int> &ids);
+
+/**
+ * @brief Marks the targets of a one-to-many search that only needs the one minimising its distance plus an exit
+ * cost (e.g. the walk on from a parking vertex), so it can stop early (see driving_dijkstra).
+ *
+ * @param g The graph that will be searched.
+ * @param ids The IDs of the targets (unknown IDs are ignored, repeated ones keep their smallest cost).
+ * @param exitCosts The exit cost of each target, in the order of (ids).
+ * @return The targets, sized for the graph.
+ */
+SearchTargets makeTargets(Graph<int> *g, const std::vector<int> &ids, const std::vector<Distance> &exitCosts);
+
+// K Shortest Routes ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief A route through the graph, as the vertices and edges it goes through.
+ */
+struct Route {
+    std::vector<Vertex<int>*> vertices;   ///< From the origin to the destination.
+    std::vector<Edge<int>*> edges;        ///< edges[i] joins vertices[i] to vertices[i + 1].
+    Distance cost = 0;                    ///< Total time.
+};
+
+/**
+ * @brief Computes up to (k) shortest loopless driving routes from an origin to a destination (Yen's algorithm).
+ *
+ * Each route after the first deviates from the one before at some spur vertex: for every spur vertex, a search
+ * runs from it to the destination without the route's vertices up to it and without the edges the routes found
+ * so far take from the same prefix. Those spur searches are independent, so they run in parallel, each over its
+ * own copy of the restrictions and its thread's SearchTree; every search stops at the destination.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param k The number of routes wanted.
+ * @param restrictions The vertices and edges no route may use.
+ * @return The routes found (fewer than k if there are no more), by increasing time.
+ */
+std::vector<Route> kShortestDrive(Graph<int> *g, const int &origin, const int &dest, int k, const Restrictions &restrictions = Restrictions::none());
+
+// Waypoint Ordering ---------------------------------------------------------------------------------------------------
+
+constexpr int MAX_EXACT_WAYPOINTS = 12; // subsets kept by orderWaypoints: 2^12 per stop
+
+/**
+ * @brief Chooses the order in which a route visits its stops, given the cost of every leg.
+ *
+ * Stop 0 is the origin and the last stop the destination; the ones between may be visited in any order. Up to
+ * MAX_EXACT_WAYPOINTS of them, the cheapest order is found by dynamic programming over the subsets visited;
+ * beyond, the nearest stop is taken next and the order is then improved by reversing sections (2-opt).
+ *
+ * @param cost The cost of the leg between every pair of stops (cost[i][j], INF if there is none).
+ * @return The stops in visiting order, starting with 0 and ending with the last one.
+ * If no order reaches every stop, they are left in the given order (one of its legs then costs INF).
+ */
+std::vector<int> orderWaypoints(const std::vector<std::vector<Distance>> &cost);
+
 // Auxiliary function to get Shortest Path -----------------------------------------------------------------------------
 
 /**
@@ -73,4 +537,13 @@ std::vector<Vertex<int>*> getPathDrive(Graph<int> *g, const int &origin, const i
  */
 std::vector<Vertex<int>*> getPathWalk(Graph<int> *g, const int &origin, const int &dest);
 
+/**
+ * @brief Retrieves the path to a vertex from a search tree, origin first.
+ *
+ * @param tree The search tree, in which the vertex is settled.
+ * @param dest The vertex at the end of the path.
+ * @return A vector of vertices representing the shortest path (only the destination if there is none).
+ */
+std::vector<Vertex<int>*> getPathTree(const SearchTree<int> &tree, Vertex<int> *dest);
+
 #endif //ALGORITHMS_H
@@ -0,0 +1,30 @@
+#ifndef ALLOC_COUNTER_H
+#define ALLOC_COUNTER_H
+
+#include <cstddef>
+
+#include "../data_structures/Graph.h"
+
+// Allocation Counter --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the number of heap allocations made by the program so far.
+ *
+ * Only counts when built with COUNT_ALLOCATIONS (CMake option of the same name), which replaces the global
+ * operator new; otherwise it always returns 0.
+ *
+ * @return The number of calls to operator new.
+ */
+size_t allocationCount();
+
+/**
+ * @brief Reports, on stderr, how many heap allocations a driving and a walking search make in steady state.
+ *
+ * Both searches are run once to size the search arrays, and then measured on a second run from the same origin.
+ *
+ * @param g The graph on which to run the searches.
+ * @param origin The ID of the origin vertex.
+ */
+void reportSearchAllocations(Graph<int> *g, const int &origin);
+
+#endif //ALLOC_COUNTER_H
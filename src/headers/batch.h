@@ -0,0 +1,68 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <vector>
+#include <ostream>
+#include <utility>
+
+#include "../data_structures/Graph.h"
+#include "../headers/algorithms.h"
+#include "../headers/driving.h"
+
+/**
+ * @brief A route query (driving or eco) of a batch, as read from its block of the input file.
+ */
+struct BatchQuery {
+    bool driving = true;                           ///< "Mode:driving" or "Mode:driving-walking".
+    int src = 0;                                   ///< "Source:<id>".
+    int dest = 0;                                  ///< "Destination:<id>".
+    int maxWalkTime = 0;                           ///< "MaxWalkTime:<minutes>", in eco.
+    int kShortest = 0;                             ///< "KShortest:<k>" (0: best and alternative routes).
+    std::vector<int> avoid_n;                      ///< "AvoidNodes:".
+    std::vector<std::pair<int,int>> avoid_seg;     ///< "AvoidSegments:".
+    Waypoints waypoints;                           ///< "IncludeNode:", "IncludeNodes:" and "WaypointOrder:".
+};
+
+// Query Execution -----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks a route query against the graph and answers it with the mode it asks for.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param query The query.
+ * @param approximate If true, eco queries are answered by eco_mode_approximate.
+ * @param out The stream the answer is written to.
+ * @return false if the query is not valid (the reason goes to stderr, and nothing is written), true otherwise.
+ */
+bool answerQuery(Graph<int> *g, const BatchQuery &query, bool approximate, std::ostream &out);
+
+// Batch Scheduling ----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Groups the queries of a batch by the search tree they can share.
+ *
+ * Driving queries need the driving tree of their source, and eco queries that one and the walking tree of their
+ * destination, each under the query's restrictions. A driving query joins the group of its driving tree; an eco
+ * query, that of whichever of its two trees more queries need (its driving tree on a tie). Groups come in the order
+ * of their first query, and queries in their original order within a group.
+ *
+ * @param g The graph the queries are answered on.
+ * @param queries The queries, in input order.
+ * @return The indices of the queries of each group, in the order to answer them.
+ */
+std::vector<std::vector<int>> groupQueries(Graph<int> *g, const std::vector<BatchQuery> &queries);
+
+/**
+ * @brief Answers the queries of a batch group by group, so that the trees a group shares are searched once.
+ *
+ * The trees are kept in the graph's tree cache, which is given room for a group's trees if it has no budget. Each
+ * answer is kept in memory, and output.txt then gets all of them in input order, separated by "---" lines (an
+ * invalid query leaves its block empty). The searches the grouping saved are reported on stderr.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param queries The queries, in input order.
+ * @param approximate If true, eco queries are answered by eco_mode_approximate.
+ */
+void runBatch(Graph<int> *g, const std::vector<BatchQuery> &queries, bool approximate);
+
+#endif //BATCH_H
@@ -0,0 +1,37 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include "../data_structures/Graph.h"
+#include "../headers/preprocessing.h"
+
+// Benchmarks ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Runs the benchmarks requested by the load options ("Benchmark:" lines), reporting on stderr.
+ *
+ * @param g The loaded (and indexed) graph.
+ * @param options The load options read from the input file.
+ */
+void runBenchmarks(Graph<int> *g, const LoadOptions &options);
+
+/**
+ * @brief Times every relaxation kernel this CPU can run over the neighbour blocks of the highest-degree vertices,
+ * and full driving searches from those vertices with the plain and structure-of-arrays adjacency.
+ *
+ * The kernels are also checked against the scalar one, on distances that some of those edges improve.
+ *
+ * @param g The loaded graph.
+ */
+void benchmarkRelaxKernels(Graph<int> *g);
+
+/**
+ * @brief Times driving searches with and without the search prefetches, on a synthetic grid much larger than
+ * the L2/L3 caches (the sample data fits in them), with the plain and structure-of-arrays adjacency.
+ *
+ * The grid's vertices are added in random order, like the IDs of a real locations file.
+ *
+ * @param side The number of vertices on each side of the grid.
+ */
+void benchmarkPrefetch(int side = 512);
+
+#endif //BENCHMARKS_H
@@ -2,35 +2,74 @@
 #define DRIVING_H
 
 #include <vector>
+#include <iostream>
 #include <utility>
 
 #include "../data_structures/Graph.h"
 
+/**
+ * @brief Stops a restricted driving route must go through, read from the input file.
+ */
+struct Waypoints {
+    std::vector<int> nodes;   ///< "IncludeNodes:<id>,<id>,..." (or a single "IncludeNode:<id>").
+    bool optimise = false;    ///< "WaypointOrder:optimal" visits them in the cheapest order; "fixed" (default) as given.
+};
+
 // Driving Computation: no restrictions --------------------------------------------------------------------------------
 
 /**
  * @brief Computes the best and alternative driving routes from an origin to a destination without any restrictions.
  *
+ * If the graph has an all-pairs driving table, the best route is looked up in it instead of searched for. Hub labels
+ * only serve the lookup of its time: they hold distances, not routes, so the route is still searched for, stopping
+ * at the destination (and not at all if the labels find it unreachable), which keeps it the one printed without
+ * labels on ties. With a tree cache, the search is complete instead, so that later queries from the same origin
+ * find it cached. The alternative route always takes a complete search, through the tree cache.
+ *
  * @param g The graph containing the vertices and edges.
  * @param origin The ID of the origin vertex.
  * @param dest The ID of the destination vertex.
- * @param batch If true, outputs the results to a file; otherwise, outputs to the console.
+ * @param out The stream the results are written to (the console by default).
  */
-void driving_mode(Graph<int> *g, const int &origin, const int &dest, bool batch = false);
+void driving_mode(Graph<int> *g, const int &origin, const int &dest, std::ostream &out = std::cout);
 
 // Driving Computation: with restrictions ------------------------------------------------------------------------------
 
 /**
- * @brief Computes the best driving route from an origin to a destination while avoiding specific nodes and edges, and optionally including a specific node.
+ * @brief Computes the best driving route from an origin to a destination while avoiding specific nodes and edges, and optionally including specific nodes.
+ *
+ * With stops to include, the legs are costed first, by one search from the origin and from each stop that ends once
+ * the stops it may lead to are settled (or from the all-pairs table, if nothing is avoided). In a fixed order that is
+ * the next stop; otherwise every stop, and the order is chosen from the table of legs (see orderWaypoints). Only the
+ * legs of that order are then read back from the searches. Without stops, the route comes from one complete search,
+ * through the graph's tree cache.
  *
  * @param g The graph containing the vertices and edges.
  * @param origin The ID of the origin vertex.
  * @param dest The ID of the destination vertex.
  * @param avoid_nodes A vector of node IDs to avoid in the route.
  * @param avoid_edges A vector of pairs representing edges to avoid in the route.
- * @param include_node The ID of a node that must be included in the route, or -1 if no such node is required.
- * @param batch If true, outputs the results to a file; otherwise, outputs to the console.
+ * @param waypoints The nodes that must be included in the route, and whether they may be reordered.
+ * @param out The stream the results are written to (the console by default).
+ */
+void driving_mode(Graph<int> *g, const int &origin, const int &dest, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges, const Waypoints &waypoints = {}, std::ostream &out = std::cout);
+
+// Driving Computation: k shortest routes ------------------------------------------------------------------------------
+
+/**
+ * @brief Computes the k fastest loopless driving routes from an origin to a destination while avoiding specific nodes and edges.
+ *
+ * The routes are written as DrivingRoute1 to DrivingRouteK, fastest first; there may be fewer if the graph has no
+ * more. The spur searches behind each route run in parallel (see kShortestDrive).
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param k The number of routes wanted.
+ * @param avoid_nodes A vector of node IDs to avoid in the routes.
+ * @param avoid_edges A vector of pairs representing edges to avoid in the routes.
+ * @param out The stream the results are written to (the console by default).
  */
-void driving_mode(Graph<int> *g, const int &origin, const int &dest, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges, const int &include_node = -1, bool batch = false);
+void k_shortest_mode(Graph<int> *g, const int &origin, const int &dest, int k, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges, std::ostream &out = std::cout);
 
 #endif //DRIVING_H
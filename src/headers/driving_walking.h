@@ -2,16 +2,70 @@
 #define DRIVING_WALKING_H
 
 #include <vector>
+#include <iostream>
 #include <utility>
 
 #include "../data_structures/Graph.h"
+#include "../headers/algorithms.h"
 
+/**
+ * @brief Computes the total time of driving from the origin to a parking vertex and walking from it to the destination.
+ *
+ * @param drive The driving search tree (rooted at the origin).
+ * @param walk The walking search tree (rooted at the destination).
+ * @param v The parking vertex.
+ * @return The sum of both distances, or INF if the vertex is unreachable by either mode.
+ */
+Distance totalTime(const SearchTree<int> &drive, const SearchTree<int> &walk, const Vertex<int> *v);
+
+/**
+ * @brief Cheap precheck for the eco modes: tells whether some parking vertex may be driven to from the origin
+ * and walked from to the destination, using the component labels instead of searching.
+ *
+ * @param g The graph containing the vertices.
+ * @param restrictions The restrictions of the query (restricted vertices cannot be parked at).
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param parkAtDest Whether the destination itself may be the parking vertex.
+ * @return false only if no parking vertex can be part of a route.
+ */
+bool mayPark(Graph<int> *g, const Restrictions &restrictions, const int &origin, const int &dest, bool parkAtDest);
+
+/**
+ * @brief Fills the driving tree from the origin and the walking tree from the destination.
+ *
+ * Without restrictions, and if the graph has all-pairs tables, the rows of both ends are copied instead of searched;
+ * otherwise both searches run at once, each through the graph's tree cache.
+ *
+ * @param g The graph containing the vertices.
+ * @param restrictions The restrictions of the query.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ */
+void searchFromEnds(Graph<int> *g, const Restrictions &restrictions, const int &origin, const int &dest);
+
+/**
+ * @brief Picks the parking vertex of an unrestricted eco query from the graph's parking index.
+ *
+ * The candidates are the destination's entries within the walking limit. Only the driving search runs, and it stops
+ * once every candidate is settled or none left can beat the best total so far. Ties are broken as in the scan over
+ * all vertices: the longer walk wins, and then the lower index.
+ *
+ * @param g The graph containing the vertices, with a parking index covering the walking limit.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param max_walk_time The maximum allowed walking time in minutes.
+ * @return The parking vertex (with its driving route in the driving tree), or nullptr if no candidate can be driven to.
+ */
+Vertex<int> *parkFromIndex(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time);
 
 /**
  * @brief Computes the most eco-friendly route from an origin to a destination, combining driving and walking.
  *
  * This function calculates the optimal route by driving to a parking node and then walking to the destination,
  * while respecting constraints such as maximum walking time and avoiding specific nodes and edges.
+ * With hub labels and no restrictions, the parking vertices are costed from the labels, and only the two routes
+ * through the chosen one are searched. Large graphs get the same treatment with parallel delta-stepping distances.
  *
  * @param g The graph containing the vertices and edges.
  * @param origin The ID of the origin vertex.
@@ -21,9 +75,9 @@
  * @param avoid_edges A vector of pairs representing edges to avoid in the route.
  */
 
-void eco_mode(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges, bool batch = false);
+void eco_mode(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges, std::ostream &out = std::cout);
 
-void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges, bool batch = false);
+void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges, std::ostream &out = std::cout);
 
 
 #endif //DRIVING_WALKING_H
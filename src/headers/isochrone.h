@@ -0,0 +1,48 @@
+#ifndef ISOCHRONE_H
+#define ISOCHRONE_H
+
+#include <vector>
+#include <utility>
+
+#include "../data_structures/Graph.h"
+#include "../headers/algorithms.h"
+
+/**
+ * @brief How the vertices of an isochrone are reached.
+ */
+enum class IsochroneMetric {
+    Driving,   ///< By car, within the budget.
+    Walking,   ///< On foot, within the budget.
+    Eco        ///< By car to a parking vertex within the budget, then on foot within the maximum walking time.
+};
+
+/**
+ * @brief Query of the isochrone mode, read from the input file.
+ */
+struct IsochroneQuery {
+    bool enabled = false;                                ///< "Mode:isochrone".
+    std::vector<int> sources;                            ///< "Sources:<id>,<id>,..." (or a single "Source:").
+    IsochroneMetric metric = IsochroneMetric::Driving;   ///< "Metric:driving|walking|eco".
+    int budget = 0;                                      ///< "Budget:<minutes>": of the trip, or of its drive in eco.
+    int walkBudget = 0;                                  ///< "MaxWalkTime:<minutes>": of the walk, in eco.
+};
+
+// Isochrone Computation -----------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes, for every source, the vertices reachable within the budget and the time to reach them.
+ *
+ * Each search is bounded by the budget (see boundedSearch), so it never expands past it. In eco, the driving search
+ * is followed by one walking search, bounded by the maximum walking time, from every parking vertex it reaches; a
+ * vertex then costs its cheapest drive plus walk. The sources are spread over the hardware threads.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param query The sources, metric and budgets.
+ * @param avoid_nodes A vector of node IDs the trips may not go through.
+ * @param avoid_edges A vector of pairs representing edges the trips may not use.
+ * @param batch If true, outputs the vertices to output.txt; otherwise, to the console.
+ */
+void isochrone_mode(Graph<int> *g, const IsochroneQuery &query, const std::vector<int> &avoid_nodes,
+                    const std::vector<std::pair<int,int>> &avoid_edges, bool batch = false);
+
+#endif //ISOCHRONE_H
@@ -0,0 +1,71 @@
+#ifndef MATRIX_H
+#define MATRIX_H
+
+#include <vector>
+#include <span>
+#include <ostream>
+
+#include "../data_structures/Graph.h"
+#include "../headers/algorithms.h"
+
+/**
+ * @brief Encoding of the cost table written by the matrix mode.
+ */
+enum class MatrixFormat {
+    CSV,     ///< Text: a header line, then one line per source and metric.
+    Binary   ///< Native-endian 32-bit integers (see writeMatrixHeader).
+};
+
+/**
+ * @brief Query of the matrix mode, read from the input file.
+ */
+struct MatrixQuery {
+    bool enabled = false;                      ///< "Mode:matrix".
+    std::vector<int> sources;                  ///< "Sources:<id>,<id>,...".
+    std::vector<int> targets;                  ///< "Targets:<id>,<id>,...".
+    MatrixFormat format = MatrixFormat::CSV;   ///< "MatrixFormat:csv|binary".
+};
+
+// Matrix Computation --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes the driving and walking costs from every source to every target, without restrictions.
+ *
+ * Each source gets one driving and one walking search, which stop as soon as every target is settled; the searches
+ * run in parallel a block of sources at a time, and each block is written as soon as it is done. If the graph has
+ * all-pairs tables, the costs are read from them instead.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param query The sources, targets and output format.
+ * @param batch If true, outputs the table to output.txt (CSV) or output.bin (binary); otherwise, to the console.
+ */
+void matrix_mode(Graph<int> *g, const MatrixQuery &query, bool batch = false);
+
+// Matrix Output -------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes the start of the table.
+ *
+ * CSV: "Source,Metric" followed by the target IDs. Binary: the bytes "DAMX", the number of sources and of targets
+ * (uint32), the source IDs and the target IDs (int32); the rows follow, each source's driving row then its walking
+ * row (uint32 per target, 4294967295 if unreachable).
+ *
+ * @param out The stream to write to.
+ * @param query The query whose table is written.
+ */
+void writeMatrixHeader(std::ostream &out, const MatrixQuery &query);
+
+/**
+ * @brief Writes the costs from one source to every target for one metric.
+ *
+ * In CSV, unreachable targets are written as "X", as in the distances file.
+ *
+ * @param out The stream to write to.
+ * @param format The encoding of the table.
+ * @param source The ID of the source.
+ * @param metric The name of the metric ("driving" or "walking"), for CSV.
+ * @param costs The cost to each target, in the order of the query.
+ */
+void writeMatrixRow(std::ostream &out, MatrixFormat format, int source, const char *metric, std::span<const Distance> costs);
+
+#endif //MATRIX_H
@@ -7,7 +7,10 @@
  *
  * This function reads the graph data from location and distance files, processes the input file to determine
  * the source, destination, and constraints, and then computes the optimal route based on the specified mode
- * (driving or eco mode).
+ * (driving, eco, matrix or isochrone mode).
+ *
+ * The input file may hold several driving and eco queries, separated by "---" lines; load options apply to all of
+ * them. They are then answered by runBatch, grouped by the search trees they share.
  *
  * Input format: ./DA_PROJ1 <locations file> <distances file> <input file> <something>
  * Note: the last argument can be anything, only the number of arguments is relevant for this function.
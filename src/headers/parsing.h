@@ -4,6 +4,10 @@
 #include <fstream>
 
 #include "../data_structures/Graph.h"
+#include "../headers/preprocessing.h"
+#include "../headers/matrix.h"
+#include "../headers/driving.h"
+#include "../headers/isochrone.h"
 
 
 /**
@@ -30,6 +34,15 @@ bool parseLocations (Graph<int> *g, const std::string &file);
  */
 bool parseDistances (Graph<int> *g, const std::string &file);
 
+/**
+ * @brief Parses a travel time (in whole minutes) from the distances file.
+ *
+ * @param text The field to parse.
+ * @return The travel time, as an edge weight of the graph.
+ * @throws std::invalid_argument or std::out_of_range if the field is not a number of minutes that fits in a weight.
+ */
+Graph<int>::Weight parseMinutes(const std::string &text);
+
 /**
  * @brief Parses a line of text to extract nodes to avoid.
  *
@@ -54,23 +67,37 @@ bool parseAvoidNodes(const std::string &line, std::vector<int> &avoid_n);
  */
 bool parseAvoidSegments(const std::string &line, std::vector<std::pair<int, int>> &avoid_seg);
 
+/**
+ * @brief Parses a comma-separated list of vertex IDs.
+ *
+ * @param list The list, without its key.
+ * @param ids The vector to store the IDs.
+ * @return true if every entry is an ID, false otherwise.
+ */
+bool parseIDs(const std::string &list, std::vector<int> &ids);
+
 /**
  * @brief Parses the input file to extract route computation parameters.
  *
  * This function reads an input file containing mode, source, destination, constraints,
  * and other parameters, and stores them in the provided variables.
  *
- * @param f The input file stream.
+ * @param f The input file stream, or one query's block of a multi-query batch.
  * @param driving A boolean indicating whether the mode is driving (true) or eco (false).
  * @param src The ID of the source vertex.
  * @param dest The ID of the destination vertex.
  * @param maxWalkTime The maximum allowed walking time (for eco mode).
  * @param avoid_n A vector to store nodes to avoid.
  * @param avoid_seg A vector to store segments to avoid.
- * @param inc_n The ID of a node to include in the route (if specified).
+ * @param waypoints The nodes to include in the route (if specified), and the order to visit them in.
+ * @param kShortest The number of driving routes asked for by "KShortest:<k>" (0 if not given).
  * @param numVert The total number of vertices in the graph.
+ * @param options The load options given in the file (e.g. "Adjacency:compressed").
+ * @param matrix The query of the matrix mode ("Mode:matrix"), which takes sources and targets instead of a source
+ * and a destination.
+ * @param isochrone The query of the isochrone mode ("Mode:isochrone"), which takes sources, a metric and a budget.
  * @return true if the input file was successfully parsed, false otherwise.
  */
-bool parseInput(std::ifstream &f, bool &driving, int &src, int &dest, int &maxWalkTime, std::vector<int> &avoid_n, std::vector<std::pair<int,int>> &avoid_seg, int &inc_n, const int numVert);
+bool parseInput(std::istream &f, bool &driving, int &src, int &dest, int &maxWalkTime, std::vector<int> &avoid_n, std::vector<std::pair<int,int>> &avoid_seg, Waypoints &waypoints, int &kShortest, const int numVert, LoadOptions &options, MatrixQuery &matrix, IsochroneQuery &isochrone);
 
 #endif //PARSING_H
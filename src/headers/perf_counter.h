@@ -0,0 +1,33 @@
+#ifndef PERF_COUNTER_H
+#define PERF_COUNTER_H
+
+#include <cstdint>
+#include <string>
+
+// Cache Miss Counter --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Hardware counter of the cache misses of this thread, read through perf_event_open on Linux.
+ *
+ * Where the counter cannot be opened (other systems, containers without perf access, perf_event_paranoid too high)
+ * available() is false, and read() always returns 0.
+ */
+class CacheMissCounter {
+public:
+    CacheMissCounter();
+    ~CacheMissCounter();
+
+    CacheMissCounter(const CacheMissCounter &) = delete;
+    CacheMissCounter &operator=(const CacheMissCounter &) = delete;
+
+    bool available() const;
+    const std::string &error() const; ///< Why the counter is not available.
+
+    uint64_t read() const; ///< Cache misses counted since the counter was opened.
+
+private:
+    int fd = -1;
+    std::string reason;
+};
+
+#endif //PERF_COUNTER_H
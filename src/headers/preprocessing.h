@@ -0,0 +1,129 @@
+#ifndef PREPROCESSING_H
+#define PREPROCESSING_H
+
+#include <vector>
+#include <optional>
+#include <string>
+
+#include "../data_structures/Graph.h"
+
+/**
+ * @brief Order in which the vertices are stored (and numbered) once the graph is loaded.
+ */
+enum class VertexOrder {
+    Input,  ///< Order of the locations file.
+    BFS,    ///< Breadth-first order.
+    RCM     ///< Reverse Cuthill-McKee order.
+};
+
+/**
+ * @brief Adjacency layout scanned by the Dijkstra kernels.
+ */
+enum class AdjacencyLayout {
+    Plain,       ///< The per-mode views of Edge pointers.
+    SoA,         ///< Parallel target/weight/edge arrays, relaxed a block at a time with SIMD where available.
+    Compressed   ///< Delta/varint neighbours and bit-packed weights.
+};
+
+/**
+ * @brief Options, read from the input file, that choose how the graph is indexed once it is loaded.
+ */
+struct LoadOptions {
+    AdjacencyLayout adjacency = AdjacencyLayout::Plain;   ///< "Adjacency:plain|soa|compressed".
+    bool reportAdjacency = false;       ///< Set when an "Adjacency:" line is given: memory per edge is reported.
+    std::optional<VertexOrder> order;   ///< "Reorder:input|bfs|rcm"; if not given, BFS with compressed adjacency.
+    bool reportCacheMisses = false;     ///< "CacheStats:on" reports search locality before and after reordering.
+    bool allPairs = false;              ///< "AllPairs:on" precomputes the driving and walking all-pairs tables.
+    bool hubLabels = false;             ///< "HubLabels:on" builds the driving and walking hub labels.
+    int arcFlagRegions = 0;             ///< "ArcFlags:<k>" builds arc flags over k regions (0: none).
+    int parkingBudget = 0;              ///< "ParkingIndex:<minutes>" indexes the parking vertices within that walk (0: none).
+    int treeCacheMiB = 0;               ///< "TreeCache:<MiB>" keeps complete search trees between queries (0: none).
+    std::optional<bool> deltaStepping;  ///< "DeltaStepping:on|off|auto": full-tree searches in parallel (auto: large graphs).
+    bool benchmarkRelax = false;        ///< "Benchmark:relax" times the block relaxation kernels.
+    bool benchmarkPrefetch = false;     ///< "Benchmark:prefetch" times searches on a large graph with and without prefetching.
+};
+
+// Vertex Renumbering --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes a breadth-first order of the vertices, so that neighbours get close indices.
+ *
+ * @param g The graph to order.
+ * @return The old index of the vertex to place at each position (see Graph::reorderVertices).
+ */
+std::vector<int> bfsOrder(Graph<int> *g);
+
+/**
+ * @brief Computes a reverse Cuthill-McKee order of the vertices, which keeps the index gap between neighbours small.
+ *
+ * Segments are taken as undirected. Each connected component starts from a pseudo-peripheral vertex, and
+ * neighbours are visited by increasing degree.
+ *
+ * @param g The graph to order.
+ * @return The old index of the vertex to place at each position (see Graph::reorderVertices).
+ */
+std::vector<int> rcmOrder(Graph<int> *g);
+
+/**
+ * @brief Parses the name of a vertex order ("input", "bfs" or "rcm").
+ *
+ * @param name The name, as written in the input file.
+ * @return The order, or nothing if the name is not valid.
+ */
+std::optional<VertexOrder> parseVertexOrder(const std::string &name);
+
+// Graph Partition -----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Splits the vertices into (k) regions of nearby vertices, for the arc flags.
+ *
+ * The seeds are chosen farthest-first (in segments, taken as undirected), and each vertex joins the region of the
+ * closest seed. Vertices no seed reaches (small disconnected pieces) join region 0.
+ *
+ * @param g The graph to partition.
+ * @param k The number of regions.
+ * @return The region of each vertex, by index.
+ */
+std::vector<int> partitionRegions(Graph<int> *g, int k);
+
+// Load-time Indexing --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the indexes requested by the load options, once both files have been parsed.
+ *
+ * @param g The loaded graph.
+ * @param options The load options read from the input file.
+ */
+void buildIndexes(Graph<int> *g, const LoadOptions &options);
+
+/**
+ * @brief Reports on stderr the memory per edge of the plain (pointer per edge), structure-of-arrays and compressed
+ * adjacency of each metric.
+ *
+ * The layouts that are not in use are built just for the report.
+ *
+ * @param g The loaded graph.
+ */
+void reportAdjacencyMemory(Graph<int> *g);
+
+/**
+ * @brief Reports on stderr how local the accesses of the searches are with the current vertex order.
+ *
+ * Prints the mean index gap between the endpoints of a segment, and the time and cache misses (when the hardware
+ * counter can be read) per settled vertex over driving and walking searches from the given origins.
+ *
+ * @param g The loaded graph.
+ * @param origins The IDs of the origins of the measured searches.
+ * @param label The name of the current order, for the report.
+ */
+void reportSearchLocality(Graph<int> *g, const std::vector<int> &origins, const std::string &label);
+
+/**
+ * @brief Reports on stderr how the graph's tree cache did: hits, misses and hit rate, evictions, and the trees it
+ * holds against its budget.
+ *
+ * @param g The graph whose cache is reported.
+ */
+void reportTreeCache(Graph<int> *g);
+
+#endif //PREPROCESSING_H
@@ -0,0 +1,46 @@
+#ifndef RELAX_KERNELS_H
+#define RELAX_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Block Relaxation Kernels --------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes which entries of a neighbour block would improve a distance: bit i of the result is set
+ * iff du + weights[i] < dist[targets[i]].
+ *
+ * @param du The distance of the vertex whose neighbours are relaxed.
+ * @param targets The neighbour index of each entry.
+ * @param weights The weight of each entry.
+ * @param n The number of entries (at most 64).
+ * @param dist The distance of each vertex.
+ * @return The improvement mask.
+ */
+using RelaxMaskKernel = uint64_t (*)(uint32_t du, const int32_t *targets, const uint16_t *weights, size_t n,
+                                     const uint32_t *dist);
+
+/**
+ * @brief A relaxation kernel and the instruction set it needs.
+ */
+struct RelaxKernel {
+    const char *name;
+    RelaxMaskKernel mask;
+};
+
+/**
+ * @brief Returns the kernels this CPU can run, from the scalar fallback to the widest one.
+ *
+ * @return The available kernels; the last one is the one searches use.
+ */
+const std::vector<RelaxKernel> &availableRelaxKernels();
+
+/**
+ * @brief Returns the widest kernel this CPU can run (AVX2, then SSE4.1, then scalar), checked once via CPUID.
+ *
+ * @return The selected kernel.
+ */
+const RelaxKernel &relaxKernel();
+
+#endif //RELAX_KERNELS_H
@@ -1,23 +1,41 @@
 #include <iostream>
+#include <algorithm>
+#include <bit>
+#include <type_traits>
+#include <queue>
+#include <barrier>
+#include <tuple>
+#include <unordered_map>
+#include <optional>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
 
 #include "../data_structures/Graph.h"
-#include "../data_structures/MutablePriorityQueue.h"
+#include "../data_structures/IndexedPriorityQueue.h"
 #include "../headers/algorithms.h"
+#include "../headers/relax_kernels.h"
+
+static_assert(std::is_same_v<Weight, uint16_t> && std::is_same_v<Distance, uint32_t>,
+              "the block relaxation kernels read 16-bit weights and 32-bit distances");
 
 
 // Edge Relaxation  ----------------------------------------------------------------------------------------------------
 /**
  * @brief Relaxes an edge for driving, updating the destination vertex's driving distance if a shorter path is found.
  *
+ * @param tree The driving search state to update.
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
  * @param edge The edge to relax.
  * @return true if the relaxation was successful (i.e., a shorter path was found), false otherwise.
  */
-bool driving_relax(Edge<int> *edge) { // d[u] + w(u,v) < d[v]
-    auto u = edge->getOrig();
-    auto v = edge->getDest();
-    if (u->getDistDrive() + edge->getWeightDrive() < v->getDistDrive() && !v->isRestricted()) {
-        v->setDistDrive(u->getDistDrive() + edge->getWeightDrive());
-        v->setPathDrive(edge);
+bool driving_relax(SearchTree<int> &tree, const Restrictions &restrictions, Vertex<int> *u, Edge<int> *edge) { // d[u] + w(u,v) < d[v]
+    auto v = edge->getOther(u);
+    if (tree.getDist(u) + edge->getWeightDrive() < tree.getDist(v) && !restrictions.isVertexRestricted(v->getIndex())
+        && !restrictions.isEdgeRestricted(edge->getIndex())) {
+        tree.setDist(v, tree.getDist(u) + edge->getWeightDrive());
+        tree.setPath(v, edge);
         return true;
     }
     return false;
@@ -26,56 +44,242 @@ bool driving_relax(Edge<int> *edge) { // d[u] + w(u,v) < d[v]
 /**
  * @brief Relaxes an edge for walking, updating the destination vertex's walking distance if a shorter path is found.
  *
+ * @param tree The walking search state to update.
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
  * @param edge The edge to relax.
  * @return true if the relaxation was successful (i.e., a shorter path was found), false otherwise.
  */
-bool walking_relax(Edge<int> *edge) { // d[u] + w(u,v) < d[v]
-    auto u = edge->getOrig();
-    auto v = edge->getDest();
-    if (u->getDistWalk() + edge->getWeightWalk() < v->getDistWalk() && !v->isRestricted()) {
-        v->setDistWalk(u->getDistWalk() + edge->getWeightWalk());
-        v->setPathWalk(edge);
+bool walking_relax(SearchTree<int> &tree, const Restrictions &restrictions, Vertex<int> *u, Edge<int> *edge) { // d[u] + w(u,v) < d[v]
+    auto v = edge->getOther(u);
+    if (tree.getDist(u) + edge->getWeightWalk() < tree.getDist(v) && !restrictions.isVertexRestricted(v->getIndex())
+        && !restrictions.isEdgeRestricted(edge->getIndex())) {
+        tree.setDist(v, tree.getDist(u) + edge->getWeightWalk());
+        tree.setPath(v, edge);
         return true;
     }
     return false;
 }
 
+// Edge lookup for compressed adjacency --------------------------------------------------------------------------------
+
+/**
+ * @brief Finds the unrestricted driving edge from u to v with the given weight, as decoded from a compressed adjacency.
+ *
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
+ * @param v The vertex the edge leads to.
+ * @param w The driving weight of the edge.
+ * @return The edge, or nullptr if all such edges are restricted.
+ */
+Edge<int> *resolveDriveEdge(const Restrictions &restrictions, Vertex<int> *u, const Vertex<int> *v, Weight w) {
+    for (auto e:u->getAdjDrive()) {
+        if (e->getOther(u) == v && e->getWeightDrive() == w && !restrictions.isEdgeRestricted(e->getIndex()))
+            return e;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Finds the unrestricted walking edge from u to v with the given weight, as decoded from a compressed adjacency.
+ *
+ * @param restrictions The vertices and edges the search may not use.
+ * @param u The vertex the edge is traversed from.
+ * @param v The vertex the edge leads to.
+ * @param w The walking weight of the edge.
+ * @return The edge, or nullptr if all such edges are restricted.
+ */
+Edge<int> *resolveWalkEdge(const Restrictions &restrictions, Vertex<int> *u, const Vertex<int> *v, Weight w) {
+    for (auto e:u->getAdjWalk()) {
+        if (e->getOther(u) == v && e->getWeightWalk() == w && !restrictions.isEdgeRestricted(e->getIndex()))
+            return e;
+    }
+    return nullptr;
+}
+
+// Prefetching ---------------------------------------------------------------------------------------------------------
+
+#ifdef SEARCH_PREFETCH
+
+namespace {
+    bool prefetching = true;
+}
+
+/**
+ * @brief Prefetches what the next iterations of a search will touch: the vertices two settles ahead, and
+ * the adjacency (or, with a structure-of-arrays adjacency, the neighbour distance slots) of the next one.
+ *
+ * @param g The graph being searched.
+ * @param pq The search's priority queue, right after extracting the current vertex.
+ * @param soa The structure-of-arrays adjacency of the metric, or nullptr.
+ * @param dist The search's distances.
+ * @param drive Whether the driving (or walking) view is scanned.
+ */
+static void prefetchFrontier(Graph<int> *g, const IndexedPriorityQueue<Distance> &pq,
+                             const SoAAdjacency<Weight, Edge<int>> *soa, const std::vector<Distance> &dist, bool drive) {
+    for (unsigned k = 2; k <= 3; k++) {
+        int n = pq.peek(k);
+        if (n >= 0) __builtin_prefetch(g->getVertex(n));
+    }
+
+    int next = pq.peek(1);
+    if (next < 0) return;
+
+    if (soa != nullptr) {
+        __builtin_prefetch(soa->weights() + soa->begin(next));
+        for (uint32_t i = soa->begin(next), end = soa->end(next); i < end; i++)
+            __builtin_prefetch(&dist[soa->targets()[i]]);
+        return;
+    }
+
+    auto u = g->getVertex(next);
+    for (auto e : drive ? u->getAdjDrive() : u->getAdjWalk())
+        __builtin_prefetch(e);
+}
+
+/**
+ * @brief Prefetches the neighbours of v before its edges are relaxed, so their loads overlap instead of
+ * being paid one after the other.
+ *
+ * @param v The vertex being settled.
+ * @param adj The view of v that is about to be scanned.
+ */
+static void prefetchNeighbours(const Vertex<int> *v, std::span<Edge<int> * const> adj) {
+    for (auto e : adj)
+        __builtin_prefetch(e->getOther(v));
+}
+
+#endif
+
+/**
+ * @brief Turns the search prefetches on or off at runtime (to compare both in one run).
+ *
+ * They are only compiled in with SEARCH_PREFETCH (CMake option of the same name, off by default).
+ *
+ * @param enabled Whether the searches should prefetch.
+ * @return false if the prefetches were not compiled in.
+ */
+bool setSearchPrefetch(bool enabled) {
+#ifdef SEARCH_PREFETCH
+    prefetching = enabled;
+    return true;
+#else
+    (void) enabled;
+    return false;
+#endif
+}
+
 // Dijkstra for Driving ------------------------------------------------------------------------------------------------
 
 /**
  * @brief Executes Dijkstra's algorithm for driving, computing the shortest driving paths from a given origin vertex.
  *
+ * Only the driving view of each adjacency is scanned, so segments that cannot be driven are never touched.
+ * If the graph has a compressed adjacency, it is decoded instead, and an edge is only resolved when it improves a distance.
+ * With a structure-of-arrays adjacency, each neighbour block goes through the CPU's widest relaxation kernel first.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * Results are left in the graph's driving SearchTree.
+ */
+void driving_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions) {
+    driving_dijkstra(g, g->getDriveTree(), origin, restrictions);
+}
+
+/**
+ * @brief Executes Dijkstra's algorithm for driving into the given search tree instead of the graph's.
+ *
+ * The graph is only read, so searches into different trees can run concurrently.
+ *
  * @param g The graph on which to execute the algorithm.
+ * @param tree The search tree that receives the results.
  * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param targets If given, the search stops as soon as all of them are settled (their distances and paths are final,
+ * the other vertices' may not be). With exit costs, it also stops once no target left can cost less, exit included,
+ * than the cheapest settled one: the unsettled targets' distances are then only upper bounds, too long to matter.
+ * If they share an arc-flag region and nothing is restricted, edges not flagged for it are skipped.
  */
-void driving_dijkstra(Graph<int> *g, const int &origin) {
+void driving_dijkstra(Graph<int> *g, SearchTree<int> &tree, const int &origin, const Restrictions &restrictions, const SearchTargets *targets) {
 
-    if (g->getVertexSet().empty()) {
+    if (g->getNumVertex() == 0) {
         return;
     }
 
-    MutablePriorityQueue<Vertex<int>> pq;
+    tree.reset(g->getNumVertex());
 
-    for (auto s:g->getVertexSet()) {
-        s->setDistDrive(INF);
-        s->setPathDrive(nullptr);
-        pq.insert(s);
-    }
+    auto &pq = tree.getQueue();
+
+    for (int i = 0; i < g->getNumVertex(); i++)
+        pq.insert(i);
 
     auto temp = g->findVertex(origin);
-    temp->setDistDrive(0);
-    pq.decreaseKey(temp);
+    tree.setDist(temp, 0);
+    pq.decreaseKey(temp->getIndex());
+
+    auto compressed = g->getCompressedDrive();
+    auto soa = g->getSoADrive();
+    const auto kernel = relaxKernel().mask;
+    const auto &dist = tree.getDistances();
+    int remaining = targets != nullptr ? targets->count : 0;
+    Distance bestExit = INF; // cheapest settled target plus its exit cost
+
+    // arc flags only hold for unrestricted searches: a restricted shortest path may need any edge
+    const ArcFlags *flags = targets != nullptr && targets->region >= 0 && restrictions.empty() ? &g->getDriveFlags() : nullptr;
+    const int region = flags != nullptr ? targets->region : 0;
+    auto flagged = [&](const Vertex<int> *u, const Edge<int> *e) {
+        return flags == nullptr || flags->test(ArcFlags::slot(e->getIndex(), e->getOrig() == u), region);
+    };
 
     while (!pq.empty()) {
-        auto v = pq.extractMin();
+        auto v = g->getVertex(pq.extractMin());
+
+        if (tree.getDist(v) == INF) break; // everything left is unreachable
 
-        if (v->isRestricted()) continue;
+        if (bestExit != INF && tree.getDist(v) + targets->minExitCost > bestExit) break; // no target left can beat it
 
-        for (auto e:v->getAdj()) {
+        if (targets != nullptr && targets->marked[v->getIndex()]) {
+            if (!targets->exitCost.empty())
+                bestExit = std::min(bestExit, tree.getDist(v) + targets->exitCost[v->getIndex()]);
+            if (--remaining == 0) break; // last target settled
+        }
 
-            if (e->isRestricted()) continue;
+        if (restrictions.isVertexRestricted(v->getIndex())) continue;
 
-            if (driving_relax(e)) pq.decreaseKey(e->getDest());
+#ifdef SEARCH_PREFETCH
+        if (prefetching) prefetchFrontier(g, pq, soa, dist, true);
+#endif
+
+        if (compressed != nullptr) {
+            Distance du = tree.getDist(v);
+            compressed->forEach(v->getIndex(), [&](int n, Weight w) {
+                if (du + w >= dist[n]) return; // no improvement: the edge itself is never looked at
+                auto e = resolveDriveEdge(restrictions, v, g->getVertex(n), w);
+                if (e != nullptr && flagged(v, e) && driving_relax(tree, restrictions, v, e)) pq.decreaseKey(n);
+            });
+            continue;
+        }
+
+        if (soa != nullptr) {
+            Distance du = tree.getDist(v);
+            for (uint32_t b = soa->begin(v->getIndex()), end = soa->end(v->getIndex()); b < end; b += 64) {
+                uint64_t mask = kernel(du, soa->targets() + b, soa->weights() + b, std::min<uint32_t>(64, end - b), dist.data());
+                for (; mask != 0; mask &= mask - 1) { // only the improving entries reach their Edge
+                    auto e = soa->edge(b + std::countr_zero(mask));
+                    if (flagged(v, e) && driving_relax(tree, restrictions, v, e)) pq.decreaseKey(e->getOther(v)->getIndex());
+                }
+            }
+            continue;
+        }
+
+#ifdef SEARCH_PREFETCH
+        if (prefetching) prefetchNeighbours(v, v->getAdjDrive());
+#endif
+
+        for (auto e:v->getAdjDrive()) {
+
+            if (flagged(v, e) && driving_relax(tree, restrictions, v, e)) pq.decreaseKey(e->getOther(v)->getIndex());
 
         }
     }
@@ -86,61 +290,1157 @@ void driving_dijkstra(Graph<int> *g, const int &origin) {
 /**
  * @brief Executes Dijkstra's algorithm for walking, computing the shortest walking paths from a given origin vertex.
  *
+ * Only the walking view of each adjacency is scanned, so segments that cannot be walked are never touched.
+ * If the graph has a compressed adjacency, it is decoded instead, and an edge is only resolved when it improves a distance.
+ * With a structure-of-arrays adjacency, each neighbour block goes through the CPU's widest relaxation kernel first.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * Results are left in the graph's walking SearchTree.
+ */
+void walking_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions) {
+    walking_dijkstra(g, g->getWalkTree(), origin, restrictions);
+}
+
+/**
+ * @brief Executes Dijkstra's algorithm for walking into the given search tree instead of the graph's.
+ *
+ * The graph is only read, so searches into different trees can run concurrently.
+ *
  * @param g The graph on which to execute the algorithm.
+ * @param tree The search tree that receives the results.
  * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param targets If given, the search stops as soon as all of them are settled (their distances and paths are final,
+ * the other vertices' may not be). With exit costs, it also stops once no target left can cost less, exit included,
+ * than the cheapest settled one: the unsettled targets' distances are then only upper bounds, too long to matter.
+ * If they share an arc-flag region and nothing is restricted, edges not flagged for it are skipped.
  */
-void walking_dijkstra(Graph<int> *g, const int &origin) {
+void walking_dijkstra(Graph<int> *g, SearchTree<int> &tree, const int &origin, const Restrictions &restrictions, const SearchTargets *targets) {
 
-    if (g->getVertexSet().empty()) {
+    if (g->getNumVertex() == 0) {
         return;
     }
 
-    MutablePriorityQueue<Vertex<int>> pq;
+    tree.reset(g->getNumVertex());
 
-    for (auto s:g->getVertexSet()) {
-        s->setDistWalk(INF);
-        s->setPathWalk(nullptr);
-        pq.insert(s);
-    }
+    auto &pq = tree.getQueue();
+
+    for (int i = 0; i < g->getNumVertex(); i++)
+        pq.insert(i);
 
     auto temp = g->findVertex(origin);
-    temp->setDistWalk(0);
-    pq.decreaseKey(temp);
+    tree.setDist(temp, 0);
+    pq.decreaseKey(temp->getIndex());
+
+    auto compressed = g->getCompressedWalk();
+    auto soa = g->getSoAWalk();
+    const auto kernel = relaxKernel().mask;
+    const auto &dist = tree.getDistances();
+    int remaining = targets != nullptr ? targets->count : 0;
+    Distance bestExit = INF; // cheapest settled target plus its exit cost
+
+    // arc flags only hold for unrestricted searches: a restricted shortest path may need any edge
+    const ArcFlags *flags = targets != nullptr && targets->region >= 0 && restrictions.empty() ? &g->getWalkFlags() : nullptr;
+    const int region = flags != nullptr ? targets->region : 0;
+    auto flagged = [&](const Vertex<int> *u, const Edge<int> *e) {
+        return flags == nullptr || flags->test(ArcFlags::slot(e->getIndex(), e->getOrig() == u), region);
+    };
 
     while (!pq.empty()) {
-        auto v = pq.extractMin();
+        auto v = g->getVertex(pq.extractMin());
+
+        if (tree.getDist(v) == INF) break; // everything left is unreachable
+
+        if (bestExit != INF && tree.getDist(v) + targets->minExitCost > bestExit) break; // no target left can beat it
+
+        if (targets != nullptr && targets->marked[v->getIndex()]) {
+            if (!targets->exitCost.empty())
+                bestExit = std::min(bestExit, tree.getDist(v) + targets->exitCost[v->getIndex()]);
+            if (--remaining == 0) break; // last target settled
+        }
+
+        if (restrictions.isVertexRestricted(v->getIndex())) continue;
+
+#ifdef SEARCH_PREFETCH
+        if (prefetching) prefetchFrontier(g, pq, soa, dist, false);
+#endif
+
+        if (compressed != nullptr) {
+            Distance du = tree.getDist(v);
+            compressed->forEach(v->getIndex(), [&](int n, Weight w) {
+                if (du + w >= dist[n]) return; // no improvement: the edge itself is never looked at
+                auto e = resolveWalkEdge(restrictions, v, g->getVertex(n), w);
+                if (e != nullptr && flagged(v, e) && walking_relax(tree, restrictions, v, e)) pq.decreaseKey(n);
+            });
+            continue;
+        }
+
+        if (soa != nullptr) {
+            Distance du = tree.getDist(v);
+            for (uint32_t b = soa->begin(v->getIndex()), end = soa->end(v->getIndex()); b < end; b += 64) {
+                uint64_t mask = kernel(du, soa->targets() + b, soa->weights() + b, std::min<uint32_t>(64, end - b), dist.data());
+                for (; mask != 0; mask &= mask - 1) { // only the improving entries reach their Edge
+                    auto e = soa->edge(b + std::countr_zero(mask));
+                    if (flagged(v, e) && walking_relax(tree, restrictions, v, e)) pq.decreaseKey(e->getOther(v)->getIndex());
+                }
+            }
+            continue;
+        }
+
+#ifdef SEARCH_PREFETCH
+        if (prefetching) prefetchNeighbours(v, v->getAdjWalk());
+#endif
+
+        for (auto e:v->getAdjWalk()) {
+
+            if (flagged(v, e) && walking_relax(tree, restrictions, v, e)) pq.decreaseKey(e->getOther(v)->getIndex());
+
+        }
+    }
+}
+
+// Bounded Searches ----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Settles every vertex within a budget of an origin, by driving or walking, and expands nothing further.
+ *
+ * Unlike driving_dijkstra and walking_dijkstra, it only touches the vertices it reaches: the distances live in a
+ * per-thread scratch array that is reset vertex by vertex, so small budgets stay cheap on large graphs, and calls on
+ * different threads may run concurrently.
+ *
+ * @param g The graph on which to execute the search.
+ * @param driving Whether to search the driving (true) or the walking (false) metric.
+ * @param origin The vertex to start from.
+ * @param budget The largest time a settled vertex may have.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @return Every settled vertex with its time, by increasing time.
+ */
+std::vector<std::pair<Vertex<int>*, Distance>> boundedSearch(Graph<int> *g, bool driving, Vertex<int> *origin, Distance budget,
+                                                           const Restrictions &restrictions) {
+    thread_local std::vector<Distance> dist; // INF everywhere between calls
+    if (dist.size() < (size_t) g->getNumVertex()) dist.resize(g->getNumVertex(), INF);
+
+    std::vector<std::pair<Vertex<int>*, Distance>> settled;
+    std::vector<int> touched = {origin->getIndex()};
+    std::priority_queue<std::pair<Distance, int>, std::vector<std::pair<Distance, int>>, std::greater<>> pq;
+    dist[origin->getIndex()] = 0;
+    pq.emplace(0, origin->getIndex());
+
+    while (!pq.empty()) {
+        auto [d, i] = pq.top();
+        pq.pop();
+        if (d > dist[i]) continue; // stale entry
+
+        auto v = g->getVertex(i);
+        settled.emplace_back(v, d);
+        if (restrictions.isVertexRestricted(i)) continue;
+
+        for (auto e:driving ? v->getAdjDrive() : v->getAdjWalk()) {
+            auto w = e->getOther(v);
+            Distance dw = d + (driving ? e->getWeightDrive() : e->getWeightWalk());
+            if (dw > budget || dw >= dist[w->getIndex()] || restrictions.isVertexRestricted(w->getIndex())
+                || restrictions.isEdgeRestricted(e->getIndex()))
+                continue;
+            if (dist[w->getIndex()] == INF) touched.push_back(w->getIndex());
+            dist[w->getIndex()] = dw;
+            pq.emplace(dw, w->getIndex());
+        }
+    }
+
+    for (int i : touched)
+        dist[i] = INF;
+    return settled;
+}
+
+// Cached Searches -----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Fills the graph's driving tree with a complete search from the origin, loaded from the graph's tree cache
+ * if it holds the tree of that origin and restrictions; otherwise the search runs and its tree is cached.
+ *
+ * Without a cache budget, this is driving_dijkstra.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ */
+void cached_driving_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions) {
+    auto &cache = g->getTreeCache();
+    if (!cache.enabled()) {
+        driving_dijkstra(g, origin, restrictions);
+        return;
+    }
+    const int root = g->findVertex(origin)->getIndex();
+    if (!cache.load(root, true, restrictions.hash(), g->getDriveTree())) {
+        driving_dijkstra(g, origin, restrictions);
+        cache.store(root, true, restrictions.hash(), g->getDriveTree());
+    }
+}
+
+/**
+ * @brief Fills the graph's walking tree with a complete search from the origin (the destination of an eco query),
+ * loaded from the graph's tree cache if it holds the tree of that origin and restrictions; otherwise the search runs
+ * and its tree is cached.
+ *
+ * Without a cache budget, this is walking_dijkstra.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ */
+void cached_walking_dijkstra(Graph<int> *g, const int &origin, const Restrictions &restrictions) {
+    auto &cache = g->getTreeCache();
+    if (!cache.enabled()) {
+        walking_dijkstra(g, origin, restrictions);
+        return;
+    }
+    const int root = g->findVertex(origin)->getIndex();
+    if (!cache.load(root, false, restrictions.hash(), g->getWalkTree())) {
+        walking_dijkstra(g, origin, restrictions);
+        cache.store(root, false, restrictions.hash(), g->getWalkTree());
+    }
+}
+
+// Concurrent Driving and Walking Searches -----------------------------------------------------------------------------
+
+namespace {
+    /*
+     * Thread kept for the walking half of driving_walking_dijkstra, started on its first call, so that each call
+     * does not pay for starting and joining a thread. It runs one task at a time.
+     */
+    class SearchWorker {
+    public:
+        ~SearchWorker() {
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                stop = true;
+            }
+            changed.notify_all();
+            if (thread.joinable()) thread.join();
+        }
+
+        // hands (task) to the worker; false if it is running another caller's task
+        bool start(std::function<void()> task) {
+            std::lock_guard<std::mutex> guard(lock);
+            if (busy) return false;
+            if (!thread.joinable()) thread = std::thread([this]() { loop(); });
+            pending = std::move(task);
+            busy = true;
+            changed.notify_all();
+            return true;
+        }
+
+        // until the task started is done
+        void wait() {
+            std::unique_lock<std::mutex> guard(lock);
+            changed.wait(guard, [this]() { return !busy; });
+        }
+
+    private:
+        std::mutex lock;
+        std::condition_variable changed;
+        std::function<void()> pending;
+        bool busy = false, stop = false;
+        std::thread thread;
+
+        void loop() {
+            std::unique_lock<std::mutex> guard(lock);
+            while (true) {
+                changed.wait(guard, [this]() { return stop || pending != nullptr; });
+                if (stop) return;
+                auto task = std::move(pending);
+                pending = nullptr;
+                guard.unlock();
+                task();
+                guard.lock();
+                busy = false;
+                changed.notify_all();
+            }
+        }
+    };
+
+    SearchWorker &searchWorker() {
+        static SearchWorker worker;
+        return worker;
+    }
+}
+
+/**
+ * @brief Fills the graph's driving tree from one origin and its walking tree from another, running both searches at
+ * once (the walking one on a worker thread kept between calls) when the hardware has more than one thread.
+ *
+ * The two searches only share the graph, which they read, so their results are the same as run one after the other.
+ * Complete searches (without targets) go through the graph's tree cache.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param driveOrigin The ID of the origin of the driving search.
+ * @param driveRestrictions The vertices and edges the driving search may not use.
+ * @param walkOrigin The ID of the origin of the walking search.
+ * @param walkRestrictions The vertices and edges the walking search may not use.
+ * @param targets If given, both searches stop as soon as all of them are settled.
+ */
+void driving_walking_dijkstra(Graph<int> *g, const int &driveOrigin, const Restrictions &driveRestrictions,
+                              const int &walkOrigin, const Restrictions &walkRestrictions, const SearchTargets *targets) {
+    auto drive = [&]() {
+        if (targets == nullptr) cached_driving_dijkstra(g, driveOrigin, driveRestrictions);
+        else driving_dijkstra(g, g->getDriveTree(), driveOrigin, driveRestrictions, targets);
+    };
+    auto walk = [&]() {
+        if (targets == nullptr) cached_walking_dijkstra(g, walkOrigin, walkRestrictions);
+        else walking_dijkstra(g, g->getWalkTree(), walkOrigin, walkRestrictions, targets);
+    };
+
+    if (std::thread::hardware_concurrency() < 2) {
+        drive();
+        walk();
+        return;
+    }
+
+    if (!searchWorker().start(walk)) { // the worker is busy with another call
+        drive();
+        walk();
+        return;
+    }
+    drive();
+    searchWorker().wait();
+}
+
+// Parallel Searches ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Makes a pool of (threads) threads (0 for one per hardware thread), the caller's included.
+ */
+SearchPool::SearchPool(unsigned threads)
+    : trees(threads == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads) {}
+
+SearchPool::~SearchPool() {
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        stop = true;
+    }
+    changed.notify_all();
+    for (auto &t : workers)
+        t.join();
+}
+
+/**
+ * @brief Runs search(i, drive, walk) for every i in [0, count) over the pool's threads, and returns when all are done.
+ *
+ * Calls are handed out one at a time, so uneven searches still balance; drive and walk are the trees of the
+ * thread running the call, reused by all its calls of every run. The graph may only be read.
+ *
+ * @param count The number of calls.
+ * @param search The work of one call; calls run concurrently, so it may only write state of its own i.
+ */
+void SearchPool::run(int count, const Search &search) {
+    if (count <= 0) return;
+
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if (workers.empty())
+            for (unsigned t = 1; t < trees.size(); t++)
+                workers.emplace_back([this, t]() { loop(t); });
+        this->search = &search;
+        this->count = count;
+        next = 0;
+        busy = workers.size();
+        round++;
+    }
+    changed.notify_all();
+
+    work(0);
+
+    std::unique_lock<std::mutex> guard(lock);
+    changed.wait(guard, [this]() { return busy == 0; });
+    this->search = nullptr;
+}
+
+// runs calls of the current run on thread (t) until none is left
+void SearchPool::work(unsigned t) {
+    for (int i = next++; i < count; i = next++)
+        (*search)(i, trees[t].drive, trees[t].walk);
+}
+
+// a worker: takes part in every run until the pool is destroyed
+void SearchPool::loop(unsigned t) {
+    unsigned done = 0; // last run taken part in
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        changed.wait(guard, [this, done]() { return stop || round != done; });
+        if (stop) return;
+        done = round;
+        guard.unlock();
+        work(t);
+        guard.lock();
+        if (--busy == 0) changed.notify_all();
+    }
+}
+
+// Parallel Delta-stepping ---------------------------------------------------------------------------------------------
+
+namespace {
+    int deltaSteppingMinVertices = 100000;
+}
+
+/**
+ * @brief Delta-stepping over the driving (drive) or walking view, shared by driving_delta_stepping and
+ * walking_delta_stepping.
+ *
+ * The threads run every phase together, between barriers. Each phase relaxes a frontier split between them,
+ * with atomic minimums on the distances, and the barrier's completion step (on one thread) files the improved
+ * vertices into buckets and picks the next frontier.
+ */
+static std::vector<Distance> deltaStepping(Graph<int> *g, const int &origin, bool drive, const Restrictions &restrictions, unsigned threads) {
+    const int n = g->getNumVertex();
+    std::vector<Distance> dist(n, INF);
+    auto root = g->findVertex(origin);
+    if (root == nullptr) return dist;
+    dist[root->getIndex()] = 0;
+    if (restrictions.isVertexRestricted(root->getIndex())) return dist; // as in Dijkstra: settled, never expanded
+
+    auto view = [&](const Vertex<int> *v) { return drive ? v->getAdjDrive() : v->getAdjWalk(); };
+    auto weight = [&](const Edge<int> *e) { return drive ? e->getWeightDrive() : e->getWeightWalk(); };
+
+    // bucket width: the mean weight, so a bucket holds about one edge's worth of distance
+    uint64_t total = 0, edges = 0;
+    for (auto v:g->getVertexSet()) {
+        for (auto e:view(v)) {
+            total += weight(e);
+            edges++;
+        }
+    }
+    const Distance delta = std::max<uint64_t>(1, edges ? total / edges : 1);
+
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::vector<int>> buckets(1, {root->getIndex()}); // bucket b: tentative distance in [b*delta, (b+1)*delta)
+    std::vector<Distance> expanded(n, INF);   // distance each vertex's light edges were last relaxed from
+    std::vector<bool> inSettled(n, false);
+    std::vector<int> settled;                 // vertices of the current bucket, for its heavy phase
+    std::vector<std::vector<int>> improved(threads);
+    std::vector<int> frontier;
+    size_t current = 0;
+    bool heavy = false, done = false;
+
+    // light frontier of the current bucket: its vertices not yet expanded at their current distance
+    auto takeLight = [&]() {
+        frontier.clear();
+        if (current >= buckets.size()) return;
+        for (int v : buckets[current]) {
+            if (dist[v] / delta != current || expanded[v] == dist[v]) continue; // stale or repeated entry
+            expanded[v] = dist[v];
+            frontier.push_back(v);
+            if (!inSettled[v]) {
+                inSettled[v] = true;
+                settled.push_back(v);
+            }
+        }
+        buckets[current].clear();
+    };
+
+    auto nextPhase = [&]() noexcept {
+        for (auto &list : improved) {
+            for (int v : list) {
+                size_t b = dist[v] / delta;
+                if (b >= buckets.size()) buckets.resize(b + 1);
+                buckets[b].push_back(v);
+            }
+            list.clear();
+        }
+
+        if (!heavy) {
+            takeLight();
+            if (!frontier.empty()) return;
+            heavy = true; // the bucket is final: its long edges, once
+            frontier.swap(settled);
+            return;
+        }
 
-        if (v->isRestricted()) continue;
+        heavy = false;
+        for (int v : frontier) inSettled[v] = false;
+        frontier.clear();
+        settled.clear();
+        while (frontier.empty() && ++current < buckets.size())
+            takeLight();
+        done = frontier.empty();
+    };
 
-        for (auto e:v->getAdj()) {
+    takeLight();
 
-            if (e->isRestricted()) continue;
+    std::barrier sync(threads, nextPhase);
+    auto worker = [&](unsigned t) {
+        while (!done) {
+            const size_t begin = frontier.size() * t / threads, end = frontier.size() * (t + 1) / threads;
+            for (size_t i = begin; i < end; i++) {
+                int vi = frontier[i];
+                auto v = g->getVertex(vi);
+                Distance dv = heavy ? dist[vi] : expanded[vi];
+                for (auto e:view(v)) {
+                    Weight w = weight(e);
+                    if ((w > delta) != heavy) continue;
+                    auto u = e->getOther(v);
+                    if (restrictions.isVertexRestricted(u->getIndex()) || restrictions.isEdgeRestricted(e->getIndex()))
+                        continue;
 
-            if (walking_relax(e)) pq.decreaseKey(e->getDest());
+                    std::atomic_ref<Distance> du(dist[u->getIndex()]);
+                    Distance old = du.load(std::memory_order_relaxed);
+                    while (dv + w < old && !du.compare_exchange_weak(old, dv + w, std::memory_order_relaxed)) {}
+                    if (dv + w < old) improved[t].push_back(u->getIndex());
+                }
+            }
+            sync.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned t = 1; t < threads; t++)
+        pool.emplace_back(worker, t);
+    worker(0);
+    for (auto &t : pool)
+        t.join();
+
+    return dist;
+}
+
+/**
+ * @brief Computes the driving distances from the origin to every vertex with parallel delta-stepping.
+ *
+ * Vertices are processed a bucket of width delta (the mean driving weight, in minutes) at a time: the edges up to
+ * delta long are relaxed by all threads until the bucket stops changing, then the longer ones once. Distances are
+ * the same as driving_dijkstra's; no paths are kept, since equal-cost ties may be broken differently.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param threads The number of threads (0 for one per hardware thread).
+ * @return The distance to each vertex, by index (INF if unreachable).
+ */
+std::vector<Distance> driving_delta_stepping(Graph<int> *g, const int &origin, const Restrictions &restrictions, unsigned threads) {
+    return deltaStepping(g, origin, true, restrictions, threads);
+}
+
+/**
+ * @brief Computes the walking distances from the origin to every vertex with parallel delta-stepping.
+ *
+ * Vertices are processed a bucket of width delta (the mean walking weight, in minutes) at a time: the edges up to
+ * delta long are relaxed by all threads until the bucket stops changing, then the longer ones once. Distances are
+ * the same as walking_dijkstra's; no paths are kept, since equal-cost ties may be broken differently.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param restrictions The vertices and edges the search may not use (none by default).
+ * @param threads The number of threads (0 for one per hardware thread).
+ * @return The distance to each vertex, by index (INF if unreachable).
+ */
+std::vector<Distance> walking_delta_stepping(Graph<int> *g, const int &origin, const Restrictions &restrictions, unsigned threads) {
+    return deltaStepping(g, origin, false, restrictions, threads);
+}
+
+/**
+ * @brief Chooses which graphs get delta-stepping for full-tree searches (see useDeltaStepping).
+ *
+ * @param minVertices The smallest graph, in vertices, to use it on (0: always; INT_MAX: never).
+ */
+void setDeltaSteppingThreshold(int minVertices) {
+    deltaSteppingMinVertices = minVertices;
+}
+
+/**
+ * @brief Tells whether full-tree searches on this graph should use delta-stepping: the graph is large enough
+ * (100000 vertices by default, see setDeltaSteppingThreshold) and there is more than one hardware thread.
+ *
+ * @param g The graph to search.
+ * @return true if delta-stepping should be used.
+ */
+bool useDeltaStepping(Graph<int> *g) {
+    if (deltaSteppingMinVertices == 0) return true;
+    return g->getNumVertex() >= deltaSteppingMinVertices && std::thread::hardware_concurrency() > 1;
+}
+
+// All-pairs Tables ----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Fills the graph's all-pairs driving and walking tables with one search per vertex and metric.
+ *
+ * The searches are spread over (threads) threads, each with its own search trees, writing disjoint rows.
+ * Running the same Dijkstra as the single-source queries keeps their paths, ties included.
+ *
+ * @param g The graph to index.
+ * @param threads The number of threads (0 for one per hardware thread).
+ */
+void computeAllPairs(Graph<int> *g, unsigned threads) {
+    const int n = g->getNumVertex();
+    auto &driveTable = g->getDriveTable();
+    auto &walkTable = g->getWalkTable();
+    driveTable.resize(n);
+    walkTable.resize(n);
+
+    parallelSearches(n, threads, [&](int i, SearchTree<int> &drive, SearchTree<int> &walk) {
+        int origin = g->getVertex(i)->getID();
+        driving_dijkstra(g, drive, origin);
+        driveTable.store(i, drive);
+        walking_dijkstra(g, walk, origin);
+        walkTable.store(i, walk);
+    });
+}
+
+/**
+ * @brief Retrieves the shortest path from the origin to the destination vertex from an all-pairs table,
+ * in time proportional to its length.
+ *
+ * @param table The all-pairs table of the metric.
+ * @param origin The origin vertex.
+ * @param dest The destination vertex.
+ * @return A vector of vertices representing the shortest path (only the destination if there is none).
+ */
+std::vector<Vertex<int>*> getPathTable(const AllPairsTable<int> &table, Vertex<int> *origin, Vertex<int> *dest) {
+    std::vector<Vertex<int>*> res;
+    auto cur_node = dest;
+    res.push_back(cur_node);
+
+    while (table.getPath(origin, cur_node) != nullptr) {
+        cur_node = table.getPath(origin, cur_node)->getOther(cur_node);
+        res.push_back(cur_node);
+    }
+
+    std::reverse(res.begin(), res.end());
+    return res;
+}
+
+// Hub Labels ----------------------------------------------------------------------------------------------------------
 
+/**
+ * @brief Builds the graph's driving and walking hub labels by pruned landmark labelling.
+ *
+ * Vertices become hubs by decreasing degree. The search from each hub skips (and does not expand) the vertices
+ * whose distance the labels built so far already give, so the labels stay small. Segments that can only be
+ * traversed one way need separate labels towards and from the hubs; without them, one label serves both ways.
+ *
+ * @param g The graph to index.
+ */
+void computeHubLabels(Graph<int> *g) {
+    const int n = g->getNumVertex();
+
+    std::vector<Vertex<int>*> hubs(g->getVertexSet().begin(), g->getVertexSet().end());
+    std::stable_sort(hubs.begin(), hubs.end(), [](auto a, auto b) {
+        return a->getAdj().size() + a->getIncoming().size() > b->getAdj().size() + b->getIncoming().size();
+    });
+
+    for (int metric = 0; metric < 2; metric++) {
+        auto view = [&](const Vertex<int> *v) { return metric == 0 ? v->getAdjDrive() : v->getAdjWalk(); };
+        auto weight = [&](const Edge<int> *e) { return metric == 0 ? e->getWeightDrive() : e->getWeightWalk(); };
+
+        bool symmetric = true; // no directed edge usable in this metric
+        for (auto v:g->getVertexSet())
+            for (auto e:view(v))
+                if (!e->isBidirectional()) symmetric = false;
+
+        std::vector<HubLabels::Label> out(n), in(symmetric ? 0 : n);
+        std::vector<Distance> dist(n, INF), hubDist(n, INF); // hubDist: by rank, the root's own label
+        std::vector<int> touched;
+        std::priority_queue<std::pair<Distance, int>, std::vector<std::pair<Distance, int>>, std::greater<>> pq;
+
+        // forward: distances from the root, into the in-labels; backward: distances to the root, into the out-labels
+        auto prunedSearch = [&](uint32_t rank, Vertex<int> *root, bool forward) {
+            auto &labels = forward && !symmetric ? in : out;
+            const auto &rootLabel = forward || symmetric ? out[root->getIndex()] : in[root->getIndex()];
+            for (auto [hub, d] : rootLabel) hubDist[hub] = d;
+
+            dist[root->getIndex()] = 0;
+            touched.push_back(root->getIndex());
+            pq.emplace(0, root->getIndex());
+
+            while (!pq.empty()) {
+                auto [d, i] = pq.top();
+                pq.pop();
+                if (d > dist[i]) continue; // stale entry
+
+                Distance known = INF;
+                for (auto [hub, hd] : labels[i])
+                    if (hubDist[hub] != INF) known = std::min(known, hubDist[hub] + hd);
+                if (known <= d) continue; // already covered by an earlier hub
+
+                labels[i].emplace_back(rank, d);
+
+                auto v = g->getVertex(i);
+                auto relax = [&](Vertex<int> *w, Weight wt) {
+                    if (d + wt < dist[w->getIndex()]) {
+                        if (dist[w->getIndex()] == INF) touched.push_back(w->getIndex());
+                        dist[w->getIndex()] = d + wt;
+                        pq.emplace(d + wt, w->getIndex());
+                    }
+                };
+                for (auto e:view(v))
+                    if (forward || e->isBidirectional()) relax(e->getOther(v), weight(e));
+                if (!forward)
+                    for (auto e:v->getIncoming())
+                        if (weight(e) != WeightTraits<int>::NO_EDGE) relax(e->getOrig(), weight(e));
+            }
+
+            for (int t : touched) dist[t] = INF;
+            touched.clear();
+            for (auto [hub, d] : rootLabel) hubDist[hub] = INF;
+        };
+
+        for (uint32_t rank = 0; rank < hubs.size(); rank++) {
+            prunedSearch(rank, hubs[rank], true);
+            if (!symmetric) prunedSearch(rank, hubs[rank], false);
+        }
+
+        (metric == 0 ? g->getDriveLabels() : g->getWalkLabels()).build(out, in, symmetric);
+    }
+}
+
+// Arc Flags -----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the graph's driving and walking arc flags for a partition of its vertices.
+ *
+ * An edge gets the flag of a region if both its ends are in it, or if it starts a shortest path to a vertex of the
+ * region entered from outside it: one backward search per such boundary vertex, spread over the hardware threads.
+ * Every shortest path into a region then only uses edges flagged for it.
+ *
+ * @param g The graph to index.
+ * @param regionOf The region of each vertex, by index (see partitionRegions).
+ * @param numRegions The number of regions (at most ArcFlags::MAX_REGIONS).
+ */
+void computeArcFlags(Graph<int> *g, const std::vector<int> &regionOf, int numRegions) {
+    const int n = g->getNumVertex();
+
+    for (int metric = 0; metric < 2; metric++) {
+        auto view = [&](const Vertex<int> *v) { return metric == 0 ? v->getAdjDrive() : v->getAdjWalk(); };
+        auto weight = [&](const Edge<int> *e) { return metric == 0 ? e->getWeightDrive() : e->getWeightWalk(); };
+        auto &flags = metric == 0 ? g->getDriveFlags() : g->getWalkFlags();
+        flags.reset(regionOf, numRegions, 2 * g->getNumEdgeIndices());
+
+        // edges inside a region lead into it; the vertices entered from another region are its boundary
+        std::vector<Vertex<int>*> boundary;
+        std::vector<bool> isBoundary(n, false);
+        for (auto u:g->getVertexSet()) {
+            for (auto e:view(u)) {
+                auto v = e->getOther(u);
+                if (regionOf[u->getIndex()] == regionOf[v->getIndex()])
+                    flags.set(ArcFlags::slot(e->getIndex(), e->getOrig() == u), regionOf[u->getIndex()]);
+                else if (!isBoundary[v->getIndex()]) {
+                    isBoundary[v->getIndex()] = true;
+                    boundary.push_back(v);
+                }
+            }
         }
+
+        parallelSearches(boundary.size(), 0, [&](int i, SearchTree<int> &tree, SearchTree<int> &) {
+            auto root = boundary[i];
+            const int region = regionOf[root->getIndex()];
+
+            // backward Dijkstra: distances to the root
+            tree.reset(n);
+            auto &pq = tree.getQueue();
+            for (int j = 0; j < n; j++)
+                pq.insert(j);
+            tree.setDist(root, 0);
+            pq.decreaseKey(root->getIndex());
+
+            std::vector<Vertex<int>*> reached;
+            while (!pq.empty()) {
+                auto v = g->getVertex(pq.extractMin());
+                if (tree.getDist(v) == INF) break;
+                reached.push_back(v);
+
+                auto relax = [&](Vertex<int> *u, const Edge<int> *e) { // e leads from u to v
+                    if (tree.getDist(v) + weight(e) < tree.getDist(u)) {
+                        tree.setDist(u, tree.getDist(v) + weight(e));
+                        pq.decreaseKey(u->getIndex());
+                    }
+                };
+                for (auto e:view(v))
+                    if (e->isBidirectional()) relax(e->getOther(v), e);
+                for (auto e:v->getIncoming())
+                    if (weight(e) != WeightTraits<int>::NO_EDGE) relax(e->getOrig(), e);
+            }
+
+            // every edge on a shortest path to the root (ties included) leads into its region
+            for (auto u:reached) {
+                for (auto e:view(u)) {
+                    auto v = e->getOther(u);
+                    if (tree.getDist(v) != INF && tree.getDist(u) == weight(e) + tree.getDist(v))
+                        flags.set(ArcFlags::slot(e->getIndex(), e->getOrig() == u), region);
+                }
+            }
+        });
     }
 }
 
+// Parking Index -------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the graph's parking index: the parking vertices within (budget) minutes of walk of every vertex.
+ *
+ * One bounded search runs backwards from every parking vertex at once: its entries are (time, parking vertex, vertex)
+ * triples, each vertex may be settled once per parking vertex, and nothing past the budget is queued. The triples
+ * are settled by increasing time, so each vertex's list comes out nearest first.
+ *
+ * @param g The graph to index.
+ * @param budget The longest walk, in minutes, the lists cover.
+ */
+void computeParkingIndex(Graph<int> *g, const Distance budget) {
+    using Item = std::tuple<Distance, int, int>; // (time, parking vertex, vertex), by index
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> pq;
+    std::unordered_map<uint64_t, Distance> best; // tentative time of each (vertex, parking vertex) pair
+    std::vector<std::vector<ParkingIndex::Entry>> lists(g->getNumVertex());
+
+    auto key = [](int v, int parking) { return uint64_t(v) << 32 | uint32_t(parking); };
+    auto push = [&](Distance time, int parking, int v) {
+        if (time > budget) return;
+        auto [it, inserted] = best.try_emplace(key(v, parking), time);
+        if (!inserted) {
+            if (time >= it->second) return;
+            it->second = time;
+        }
+        pq.emplace(time, parking, v);
+    };
+
+    for (auto v:g->getVertexSet())
+        if (v->hasParking()) push(0, v->getIndex(), v->getIndex());
+
+    while (!pq.empty()) {
+        auto [time, parking, i] = pq.top();
+        pq.pop();
+        if (time > best[key(i, parking)]) continue; // stale entry
+
+        lists[i].push_back({parking, time});
+
+        // backwards: to the vertices whose walking searches reach this one through the edge
+        auto v = g->getVertex(i);
+        for (auto e:v->getAdjWalk())
+            if (e->isBidirectional()) push(time + e->getWeightWalk(), parking, e->getOther(v)->getIndex());
+        for (auto e:v->getIncoming())
+            if (e->getWeightWalk() != WeightTraits<int>::NO_EDGE) push(time + e->getWeightWalk(), parking, e->getOrig()->getIndex());
+    }
+
+    g->getParkingIndex().build(lists, budget);
+}
+
 // Auxiliary Function to set up for Dijkstra execution -----------------------------------------------------------------
 
 /**
- * @brief Resets the graph's vertices and edges to their initial state, allowing Dijkstra's algorithm to be re-run.
+ * @brief Resets the graph's search trees, allowing Dijkstra's algorithm to be re-run.
+ *
+ * Restrictions are not part of the graph (see Restrictions), so there is nothing else to undo.
  *
  * @param g The graph to reset.
  */
 void setup(Graph<int> *g) {
-    for (auto s:g->getVertexSet()) {
-        s->setRestricted(false);   //To allow rerunning the driving_dijkstra and find 2 different paths
-        s->setPathDrive(nullptr);
-        s->setPathWalk(nullptr);
-        s->setDistDrive(INF);
-        s->setDistWalk(INF);
+    g->getDriveTree().reset(g->getNumVertex());
+    g->getWalkTree().reset(g->getNumVertex());
+}
+
+// Reachability Prechecks ----------------------------------------------------------------------------------------------
+
+/**
+ * @brief Tells, in O(1), whether (to) may be reachable from (from) by driving, using the graph's component labels.
+ *
+ * @param g The graph containing the vertices.
+ * @param from The origin vertex.
+ * @param to The destination vertex.
+ * @return false only if they are in different driving components (true if the graph has no labels).
+ */
+bool mayDrive(Graph<int> *g, const Vertex<int> *from, const Vertex<int> *to) {
+    if (!g->hasComponents() || from == nullptr || to == nullptr) return true;
+    return g->getDriveComponent(from) == g->getDriveComponent(to);
+}
+
+/**
+ * @brief Tells, in O(1), whether (to) may be reachable from (from) by walking, using the graph's component labels.
+ *
+ * @param g The graph containing the vertices.
+ * @param from The origin vertex.
+ * @param to The destination vertex.
+ * @return false only if they are in different walking components (true if the graph has no labels).
+ */
+bool mayWalk(Graph<int> *g, const Vertex<int> *from, const Vertex<int> *to) {
+    if (!g->hasComponents() || from == nullptr || to == nullptr) return true;
+    return g->getWalkComponent(from) == g->getWalkComponent(to);
+}
+
+// Query Restrictions --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the restriction masks of a query: the vertices to avoid, and the edges of the segments to avoid.
+ *
+ * Each segment (u,v) restricts the edges that can be traversed from u to v (a bidirectional segment is then
+ * restricted both ways), found with one hash lookup.
+ *
+ * @param g The graph that will be searched.
+ * @param avoid_nodes The IDs of the vertices to avoid.
+ * @param avoid_edges The segments to avoid, as pairs of vertex IDs.
+ * @return The restriction masks, sized for the graph.
+ */
+Restrictions makeRestrictions(Graph<int> *g, const std::vector<int> &avoid_nodes, const std::vector<std::pair<int,int>> &avoid_edges) {
+    Restrictions restrictions(g->getNumVertex(), g->getNumEdgeIndices());
+
+    for (int an:avoid_nodes) {
+        auto v = g->findVertex(an);
+        if (v != nullptr) restrictions.restrictVertex(v->getIndex());
+    }
+
+    for (auto p:avoid_edges) {
+        for (auto e:g->findSegment(p.first, p.second))
+            restrictions.restrictEdge(e->getIndex());
+    }
+
+    return restrictions;
+}
 
-        for (auto e:s->getAdj()) {
-            e->setRestricted(false);
+/**
+ * @brief Marks the vertices a one-to-many search has to settle before it can stop.
+ *
+ * @param g The graph that will be searched.
+ * @param ids The IDs of the targets (unknown IDs are ignored, repeated ones counted once).
+ * @return The targets, sized for the graph.
+ */
+SearchTargets makeTargets(Graph<int> *g, const std::vector<int> &ids) {
+    SearchTargets targets;
+    targets.marked.assign(g->getNumVertex(), false);
+
+    for (int id:ids) {
+        auto v = g->findVertex(id);
+        if (v != nullptr && !targets.marked[v->getIndex()]) {
+            targets.marked[v->getIndex()] = true;
+            targets.count++;
         }
     }
+
+    const auto &flags = g->getDriveFlags(); // both metrics are flagged over the same partition
+    if (!flags.empty()) {
+        for (int i = 0; i < g->getNumVertex(); i++) {
+            if (!targets.marked[i]) continue;
+            if (targets.region == -1) targets.region = flags.region(i);
+            else if (targets.region != flags.region(i)) {
+                targets.region = -1; // targets in several regions: no pruning
+                break;
+            }
+        }
+    }
+
+    return targets;
+}
+
+/**
+ * @brief Marks the targets of a one-to-many search that only needs the one minimising its distance plus an exit
+ * cost (e.g. the walk on from a parking vertex), so it can stop early (see driving_dijkstra).
+ *
+ * @param g The graph that will be searched.
+ * @param ids The IDs of the targets (unknown IDs are ignored, repeated ones keep their smallest cost).
+ * @param exitCosts The exit cost of each target, in the order of (ids).
+ * @return The targets, sized for the graph.
+ */
+SearchTargets makeTargets(Graph<int> *g, const std::vector<int> &ids, const std::vector<Distance> &exitCosts) {
+    auto targets = makeTargets(g, ids);
+    targets.exitCost.assign(g->getNumVertex(), INF);
+    targets.minExitCost = INF;
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        auto v = g->findVertex(ids[i]);
+        if (v == nullptr) continue;
+        auto &cost = targets.exitCost[v->getIndex()];
+        cost = std::min(cost, exitCosts[i]);
+        targets.minExitCost = std::min(targets.minExitCost, cost);
+    }
+
+    return targets;
+}
+
+// K Shortest Routes ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes up to (k) shortest loopless driving routes from an origin to a destination (Yen's algorithm).
+ *
+ * Each route after the first deviates from the one before at some spur vertex: for every spur vertex, a search
+ * runs from it to the destination without the route's vertices up to it and without the edges the routes found
+ * so far take from the same prefix. Those spur searches are independent, so they run in parallel, each over its
+ * own copy of the restrictions and its thread's SearchTree; every search stops at the destination. One SearchPool
+ * runs the spur searches of every round, so its threads are started, and their trees sized, once per call.
+ *
+ * @param g The graph on which to execute the algorithm.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param k The number of routes wanted.
+ * @param restrictions The vertices and edges no route may use.
+ * @return The routes found (fewer than k if there are no more), by increasing time.
+ */
+std::vector<Route> kShortestDrive(Graph<int> *g, const int &origin, const int &dest, int k, const Restrictions &restrictions) {
+    std::vector<Route> found, candidates;
+    auto target = g->findVertex(dest);
+    if (k <= 0 || g->findVertex(origin) == nullptr || target == nullptr) return found;
+    const auto stop = makeTargets(g, {dest});
+
+    // the route the tree holds from (spur) to the destination, after (root), or nothing if the destination is unreached
+    auto spurRoute = [&](const SearchTree<int> &tree, const Route &root, Vertex<int> *spur) -> std::optional<Route> {
+        if (tree.getDist(target) == INF) return std::nullopt;
+        Route route = root;
+        std::vector<Edge<int>*> tail;
+        for (auto v = target; v != spur; v = tree.getPath(v)->getOther(v))
+            tail.push_back(tree.getPath(v));
+        for (auto it = tail.rbegin(); it != tail.rend(); ++it) {
+            route.vertices.push_back((*it)->getOther(route.vertices.back()));
+            route.edges.push_back(*it);
+        }
+        route.cost += tree.getDist(target);
+        return route;
+    };
+
+    SearchTree<int> tree;
+    driving_dijkstra(g, tree, origin, restrictions, &stop);
+    auto first = spurRoute(tree, Route{{g->findVertex(origin)}, {}, 0}, g->findVertex(origin));
+    if (!first) return found;
+    found.push_back(*first);
+
+    SearchPool pool; // its threads and their trees serve every round
+    while ((int) found.size() < k) {
+        const Route &last = found.back();
+        const int spurs = last.edges.size(); // every vertex but the destination
+        std::vector<std::optional<Route>> spurred(spurs);
+
+        pool.run(spurs, [&](int i, SearchTree<int> &drive, SearchTree<int> &) {
+            Route root{{last.vertices.begin(), last.vertices.begin() + i + 1}, {last.edges.begin(), last.edges.begin() + i}, 0};
+            for (auto e:root.edges)
+                root.cost += e->getWeightDrive();
+
+            Restrictions spur = restrictions;
+            for (int j = 0; j < i; j++)
+                spur.restrictVertex(root.vertices[j]->getIndex()); // loopless: the root is not revisited
+            for (const auto &route:found)
+                if (route.edges.size() > (size_t) i && std::equal(root.edges.begin(), root.edges.end(), route.edges.begin()))
+                    spur.restrictEdge(route.edges[i]->getIndex()); // leave the prefix another way than found routes
+
+            driving_dijkstra(g, drive, root.vertices.back()->getID(), spur, &stop);
+            spurred[i] = spurRoute(drive, root, root.vertices.back());
+        });
+
+        for (auto &route:spurred) {
+            if (!route) continue;
+            bool known = false;
+            for (const auto &other:candidates)
+                known = known || other.edges == route->edges;
+            if (!known) candidates.push_back(std::move(*route));
+        }
+
+        if (candidates.empty()) break;
+        auto best = std::min_element(candidates.begin(), candidates.end(), [](const Route &a, const Route &b) {
+            return a.cost < b.cost;
+        });
+        found.push_back(std::move(*best));
+        candidates.erase(best);
+    }
+
+    return found;
+}
+
+// Waypoint Ordering ---------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Chooses the order in which a route visits its stops, given the cost of every leg.
+ *
+ * Stop 0 is the origin and the last stop the destination; the ones between may be visited in any order. Up to
+ * MAX_EXACT_WAYPOINTS of them, the cheapest order is found by dynamic programming over the subsets visited;
+ * beyond, the nearest stop is taken next and the order is then improved by reversing sections (2-opt).
+ *
+ * @param cost The cost of the leg between every pair of stops (cost[i][j], INF if there is none).
+ * @return The stops in visiting order, starting with 0 and ending with the last one.
+ * If no order reaches every stop, they are left in the given order (one of its legs then costs INF).
+ */
+std::vector<int> orderWaypoints(const std::vector<std::vector<Distance>> &cost) {
+    const int m = cost.size(), k = m - 2; // stops between the ends
+    auto add = [](Distance a, Distance b) { return a == INF || b == INF ? INF : a + b; };
+
+    std::vector<int> order = {0};
+    if (k <= 0) {
+        if (m > 1) order.push_back(m - 1);
+        return order;
+    }
+
+    if (k <= MAX_EXACT_WAYPOINTS) {
+        // best[mask][j]: cheapest way from the origin through the stops of mask, ending at stop j + 1 (in mask)
+        std::vector<std::vector<Distance>> best(1 << k, std::vector<Distance>(k, INF));
+        std::vector<std::vector<int>> prev(1 << k, std::vector<int>(k, -1));
+        for (int j = 0; j < k; j++)
+            best[1 << j][j] = cost[0][j + 1];
+
+        for (int mask = 1; mask < (1 << k); mask++) {
+            for (int j = 0; j < k; j++) {
+                if (!(mask >> j & 1) || best[mask][j] == INF) continue;
+                for (int next = 0; next < k; next++) {
+                    if (mask >> next & 1) continue;
+                    Distance d = add(best[mask][j], cost[j + 1][next + 1]);
+                    if (d < best[mask | 1 << next][next]) {
+                        best[mask | 1 << next][next] = d;
+                        prev[mask | 1 << next][next] = j;
+                    }
+                }
+            }
+        }
+
+        const int full = (1 << k) - 1;
+        int last = 0;
+        for (int j = 1; j < k; j++)
+            if (add(best[full][j], cost[j + 1][m - 1]) < add(best[full][last], cost[last + 1][m - 1])) last = j;
+
+        if (add(best[full][last], cost[last + 1][m - 1]) == INF) { // some stop cannot be reached: no tour to follow
+            for (int i = 1; i < m; i++)
+                order.push_back(i);
+            return order;
+        }
+
+        std::vector<int> middle;
+        for (int mask = full, j = last; j != -1; ) {
+            middle.push_back(j + 1);
+            int p = prev[mask][j];
+            mask &= ~(1 << j);
+            j = p;
+        }
+        order.insert(order.end(), middle.rbegin(), middle.rend());
+        order.push_back(m - 1);
+        return order;
+    }
+
+    // nearest stop first
+    std::vector<bool> visited(m, false);
+    for (int step = 0, cur = 0; step < k; step++) {
+        int next = -1;
+        for (int j = 1; j <= k; j++)
+            if (!visited[j] && (next == -1 || cost[cur][j] < cost[cur][next])) next = j;
+        visited[next] = true;
+        order.push_back(next);
+        cur = next;
+    }
+    order.push_back(m - 1);
+
+    // then reverse any section that makes the whole route cheaper (legs may not cost the same both ways)
+    auto total = [&](const std::vector<int> &o) {
+        Distance d = 0;
+        for (size_t i = 0; i + 1 < o.size(); i++)
+            d = add(d, cost[o[i]][o[i + 1]]);
+        return d;
+    };
+    Distance current = total(order);
+    for (bool improved = true; improved; ) {
+        improved = false;
+        for (int i = 1; i < k; i++) {
+            for (int j = i + 1; j <= k; j++) {
+                std::reverse(order.begin() + i, order.begin() + j + 1);
+                Distance d = total(order);
+                if (d < current) {
+                    current = d;
+                    improved = true;
+                } else {
+                    std::reverse(order.begin() + i, order.begin() + j + 1);
+                }
+            }
+        }
+    }
+    return order;
 }
 
 // Auxiliary function to get Shortest Path -----------------------------------------------------------------------------
@@ -155,11 +1455,12 @@ void setup(Graph<int> *g) {
  */
 std::vector<Vertex<int>*> getPathDrive(Graph<int> *g, const int &origin, const int &dest) {
     std::vector<Vertex<int>*> res;
+    auto &tree = g->getDriveTree();
     auto cur_node = g->findVertex(dest);
     res.push_back(cur_node);
 
-    while (cur_node->getPathDrive() != nullptr) {
-        cur_node = cur_node->getPathDrive()->getOrig();
+    while (tree.getPath(cur_node) != nullptr) {
+        cur_node = tree.getPath(cur_node)->getOther(cur_node);
         res.insert(res.begin(), cur_node);
     }
 
@@ -176,13 +1477,35 @@ std::vector<Vertex<int>*> getPathDrive(Graph<int> *g, const int &origin, const i
  */
 std::vector<Vertex<int>*> getPathWalk(Graph<int> *g, const int &origin, const int &dest) {
     std::vector<Vertex<int>*> res;
+    auto &tree = g->getWalkTree();
     auto cur_node = g->findVertex(dest);
     res.push_back(cur_node);
 
-    while (cur_node->getPathWalk() != nullptr) {
-        cur_node = cur_node->getPathWalk()->getOrig();
+    while (tree.getPath(cur_node) != nullptr) {
+        cur_node = tree.getPath(cur_node)->getOther(cur_node);
         res.insert(res.begin(), cur_node);
     }
 
     return res;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Retrieves the path to a vertex from a search tree, origin first.
+ *
+ * @param tree The search tree, in which the vertex is settled.
+ * @param dest The vertex at the end of the path.
+ * @return A vector of vertices representing the shortest path (only the destination if there is none).
+ */
+std::vector<Vertex<int>*> getPathTree(const SearchTree<int> &tree, Vertex<int> *dest) {
+    std::vector<Vertex<int>*> res;
+    auto cur_node = dest;
+    res.push_back(cur_node);
+
+    while (tree.getPath(cur_node) != nullptr) {
+        cur_node = tree.getPath(cur_node)->getOther(cur_node);
+        res.push_back(cur_node);
+    }
+
+    std::reverse(res.begin(), res.end());
+    return res;
+}
@@ -0,0 +1,80 @@
+#include <iostream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+#include "../headers/alloc_counter.h"
+#include "../headers/algorithms.h"
+
+namespace {
+    std::atomic<size_t> allocations{0};
+}
+
+#ifdef COUNT_ALLOCATIONS
+
+// Replacement of the global allocation functions: every other form of operator new ends up calling these.
+
+void *operator new(const std::size_t size) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void *operator new[](const std::size_t size) {
+    return ::operator new(size);
+}
+
+void operator delete(void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+void operator delete[](void *p, std::size_t) noexcept {
+    std::free(p);
+}
+
+#endif
+
+// Allocation Counter --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the number of heap allocations made by the program so far.
+ *
+ * Only counts when built with COUNT_ALLOCATIONS (CMake option of the same name), which replaces the global
+ * operator new; otherwise it always returns 0.
+ *
+ * @return The number of calls to operator new.
+ */
+size_t allocationCount() {
+    return allocations.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Reports, on stderr, how many heap allocations a driving and a walking search make in steady state.
+ *
+ * Both searches are run once to size the search arrays, and then measured on a second run from the same origin.
+ *
+ * @param g The graph on which to run the searches.
+ * @param origin The ID of the origin vertex.
+ */
+void reportSearchAllocations(Graph<int> *g, const int &origin) {
+    driving_dijkstra(g, origin);
+    walking_dijkstra(g, origin);
+
+    size_t before = allocationCount();
+    driving_dijkstra(g, origin);
+    size_t afterDrive = allocationCount();
+    walking_dijkstra(g, origin);
+    size_t afterWalk = allocationCount();
+
+    std::cerr << "Allocations per driving search: " << afterDrive - before << '\n';
+    std::cerr << "Allocations per walking search: " << afterWalk - afterDrive << '\n';
+}
@@ -0,0 +1,153 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <map>
+#include <tuple>
+#include <algorithm>
+
+#include "../headers/batch.h"
+#include "../headers/driving.h"
+#include "../headers/driving_walking.h"
+
+using namespace std;
+
+// Query Execution -----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Checks a route query against the graph and answers it with the mode it asks for.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param query The query.
+ * @param approximate If true, eco queries are answered by eco_mode_approximate.
+ * @param out The stream the answer is written to.
+ * @return false if the query is not valid (the reason goes to stderr, and nothing is written), true otherwise.
+ */
+bool answerQuery(Graph<int> *g, const BatchQuery &query, const bool approximate, ostream &out) {
+    const auto &waypoints = query.waypoints;
+    const bool restricted = !query.avoid_n.empty() || !query.avoid_seg.empty() || !waypoints.nodes.empty();
+
+    for (int i : waypoints.nodes) {
+        if (g->findVertex(i) == nullptr) {
+            cerr << "Node to include must exist in the graph.\n";
+            return false;
+        }
+    }
+
+    for (int i : query.avoid_n) {
+        int inc_n = waypoints.nodes.empty() ? -1 : waypoints.nodes[0]; // the include node it clashes with, if any
+        if (find(waypoints.nodes.begin(), waypoints.nodes.end(), i) != waypoints.nodes.end())
+            inc_n = i;
+
+        if (i == inc_n || i == query.src || i == query.dest) {
+            cerr << "Error: Avoided node (" << i << ") cannot be the source ("
+                 << query.src << "), destination (" << query.dest << "), or include node ("
+                 << inc_n << ").\n";
+            return false;
+        }
+    }
+
+    if (query.driving && query.kShortest > 0) {
+        if (!waypoints.nodes.empty()) {
+            cerr << "Error: KShortest cannot be combined with nodes to include.\n";
+            return false;
+        }
+        k_shortest_mode(g, query.src, query.dest, query.kShortest, query.avoid_n, query.avoid_seg, out);
+    }
+    else if (query.driving && !restricted)
+        driving_mode(g, query.src, query.dest, out);
+    else if (query.driving && restricted)
+        driving_mode(g, query.src, query.dest, query.avoid_n, query.avoid_seg, waypoints, out);
+    else {
+      if (approximate)
+        eco_mode_approximate(g, query.src, query.dest, query.maxWalkTime, query.avoid_n, query.avoid_seg, out);
+      else
+        eco_mode(g, query.src, query.dest, query.maxWalkTime, query.avoid_n, query.avoid_seg, out);
+    }
+    return true;
+}
+
+// Batch Scheduling ----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Groups the queries of a batch by the search tree they can share.
+ *
+ * Driving queries need the driving tree of their source, and eco queries that one and the walking tree of their
+ * destination, each under the query's restrictions. A driving query joins the group of its driving tree; an eco
+ * query, that of whichever of its two trees more queries need (its driving tree on a tie). Groups come in the order
+ * of their first query, and queries in their original order within a group.
+ *
+ * @param g The graph the queries are answered on.
+ * @param queries The queries, in input order.
+ * @return The indices of the queries of each group, in the order to answer them.
+ */
+vector<vector<int>> groupQueries(Graph<int> *g, const vector<BatchQuery> &queries) {
+    using Root = tuple<bool, int, uint64_t>; // driving, root ID, hash of the restrictions
+
+    vector<Root> drive(queries.size()), walk(queries.size());
+    map<Root, int> need; // queries that need each tree
+    for (size_t i = 0; i < queries.size(); i++) {
+        const auto &q = queries[i];
+        const uint64_t hash = makeRestrictions(g, q.avoid_n, q.avoid_seg).hash();
+        drive[i] = {true, q.src, hash};
+        walk[i] = {false, q.dest, hash};
+        need[drive[i]]++;
+        if (!q.driving) need[walk[i]]++;
+    }
+
+    vector<vector<int>> groups;
+    map<Root, int> groupOf;
+    for (size_t i = 0; i < queries.size(); i++) {
+        const Root &root = !queries[i].driving && need[walk[i]] > need[drive[i]] ? walk[i] : drive[i];
+        auto [it, added] = groupOf.emplace(root, groups.size());
+        if (added) groups.emplace_back();
+        groups[it->second].push_back(i);
+    }
+    return groups;
+}
+
+/**
+ * @brief Answers the queries of a batch group by group, so that the trees a group shares are searched once.
+ *
+ * The trees are kept in the graph's tree cache, which is given room for a group's trees if it has no budget. Each
+ * answer is kept in memory, and output.txt then gets all of them in input order, separated by "---" lines (an
+ * invalid query leaves its block empty). The searches the grouping saved are reported on stderr.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param queries The queries, in input order.
+ * @param approximate If true, eco queries are answered by eco_mode_approximate.
+ */
+void runBatch(Graph<int> *g, const vector<BatchQuery> &queries, const bool approximate) {
+    const int GROUP_TREES = 4; // the group's driving and walking trees, and those only one query of it searches
+
+    auto &cache = g->getTreeCache();
+    const size_t budget = cache.budget();
+    if (budget == 0)
+        cache.setBudget(GROUP_TREES * g->getNumVertex() * (sizeof(Distance) + sizeof(Edge<int> *)));
+    const auto before = cache.stats();
+
+    const auto groups = groupQueries(g, queries);
+    vector<string> answers(queries.size());
+
+    for (const auto &group : groups) {
+        for (int i : group) {
+            ostringstream answer;
+            if (answerQuery(g, queries[i], approximate, answer))
+                answers[i] = answer.str();
+        }
+    }
+
+    ofstream out("output.txt");
+    for (size_t i = 0; i < answers.size(); i++)
+        out << (i ? "---\n" : "") << answers[i];
+    out.close();
+
+    const auto after = cache.stats();
+    const size_t hits = after.hits - before.hits, searches = hits + after.misses - before.misses;
+    cerr << "Batch: " << queries.size() << " queries in " << groups.size() << " groups, " << hits << " of "
+         << searches << " tree searches saved (" << (searches ? 100.0 * hits / searches : 0.0) << "%)\n";
+
+    if (budget == 0) { // the room was only for the batch
+        cache.clear();
+        cache.setBudget(0);
+    }
+}
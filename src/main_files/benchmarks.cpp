@@ -0,0 +1,182 @@
+#include <iostream>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <random>
+#include <numeric>
+#include <string>
+
+#include "../headers/benchmarks.h"
+#include "../headers/algorithms.h"
+#include "../headers/relax_kernels.h"
+
+using namespace std;
+
+namespace {
+    volatile uint64_t sink; // keeps the timed work from being optimised away
+
+    double secondsSince(const chrono::steady_clock::time_point start) {
+        return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+// Benchmarks ----------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Runs the benchmarks requested by the load options ("Benchmark:" lines), reporting on stderr.
+ *
+ * @param g The loaded (and indexed) graph.
+ * @param options The load options read from the input file.
+ */
+void runBenchmarks(Graph<int> *g, const LoadOptions &options) {
+    if (options.benchmarkRelax)
+        benchmarkRelaxKernels(g);
+    if (options.benchmarkPrefetch)
+        benchmarkPrefetch();
+}
+
+/**
+ * @brief Times every relaxation kernel this CPU can run over the neighbour blocks of the highest-degree vertices,
+ * and full driving searches from those vertices with the plain and structure-of-arrays adjacency.
+ *
+ * The kernels are also checked against the scalar one, on distances that some of those edges improve.
+ *
+ * @param g The loaded graph.
+ */
+void benchmarkRelaxKernels(Graph<int> *g) {
+    if (g->getNumVertex() == 0) return;
+
+    bool built = g->getSoADrive() != nullptr;
+    if (!built) g->buildSoAAdjacency();
+    auto soa = g->getSoADrive();
+
+    // the highest-degree vertices of the driving adjacency
+    vector<int> hubs(g->getNumVertex());
+    for (int i = 0; i < g->getNumVertex(); i++) hubs[i] = i;
+    auto degree = [&](int u) { return soa->end(u) - soa->begin(u); };
+    stable_sort(hubs.begin(), hubs.end(), [&](int a, int b) { return degree(a) > degree(b); });
+    hubs.resize(min<size_t>(hubs.size(), 32));
+
+    size_t edges = 0;
+    for (int u : hubs) edges += degree(u);
+    if (edges == 0) {
+        if (!built) g->dropSoAAdjacency();
+        return;
+    }
+
+    // distances part way through a search: those of a complete search from the highest-degree vertex, with half of
+    // them raised as if not yet settled, so that some edges improve them (on final distances none would)
+    driving_dijkstra(g, g->getVertex(hubs[0])->getID());
+    vector<Distance> dist = g->getDriveTree().getDistances();
+    mt19937 rng(2025);
+    uniform_int_distribution<Distance> raise(1, 60);
+    for (auto &d : dist)
+        if (d != INF && rng() % 2) d += raise(rng);
+    auto du = [&](int u) { return dist[u] == INF ? 0 : dist[u]; };
+
+    auto masks = [&](RelaxMaskKernel kernel, vector<uint64_t> &out) {
+        out.clear();
+        for (int u : hubs)
+            for (uint32_t b = soa->begin(u), end = soa->end(u); b < end; b += 64)
+                out.push_back(kernel(du(u), soa->targets() + b, soa->weights() + b, min<uint32_t>(64, end - b), dist.data()));
+    };
+
+    vector<uint64_t> reference, result;
+    masks(availableRelaxKernels()[0].mask, reference);
+    uint64_t improved = 0;
+    for (uint64_t mask : reference) improved += popcount(mask);
+
+    cerr << "Relax kernels over the " << hubs.size() << " highest-degree vertices (degree " << degree(hubs.back())
+         << " to " << degree(hubs[0]) << ", " << edges << " edges, " << improved << " improving):\n";
+    if (improved == 0)
+        cerr << "  no edge improves a distance, so the kernels are only checked on empty masks\n";
+    const size_t reps = max<size_t>(1, 4000000 / edges);
+
+    for (auto &kernel : availableRelaxKernels()) {
+        masks(kernel.mask, result);
+        bool agrees = result == reference;
+
+        auto start = chrono::steady_clock::now();
+        uint64_t improving = 0;
+        for (size_t r = 0; r < reps; r++)
+            for (int u : hubs)
+                for (uint32_t b = soa->begin(u), end = soa->end(u); b < end; b += 64)
+                    improving += popcount(kernel.mask(du(u), soa->targets() + b, soa->weights() + b,
+                                                      min<uint32_t>(64, end - b), dist.data()));
+        double seconds = secondsSince(start);
+        sink = improving;
+
+        cerr << "  " << kernel.name << ": " << seconds * 1e9 / (double(reps) * edges) << " ns/edge"
+             << (&kernel == &relaxKernel() ? " (selected)" : "") << (agrees ? "" : " MISMATCH with scalar") << '\n';
+    }
+
+    // whole searches from the same vertices, with each layout (the compressed one takes precedence if in use)
+    for (int layout = 0; layout < 2 && g->getCompressedDrive() == nullptr; layout++) {
+        if (layout == 0) g->dropSoAAdjacency(); else g->buildSoAAdjacency();
+
+        auto start = chrono::steady_clock::now();
+        for (int u : hubs)
+            driving_dijkstra(g, g->getVertex(u)->getID());
+        double seconds = secondsSince(start);
+
+        cerr << "  driving search, " << (layout == 0 ? "plain" : "soa") << " adjacency: "
+             << seconds * 1e6 / hubs.size() << " us/search\n";
+    }
+
+    if (!built) g->dropSoAAdjacency();
+}
+
+/**
+ * @brief Times driving searches with and without the search prefetches, on a synthetic grid much larger than
+ * the L2/L3 caches (the sample data fits in them), with the plain and structure-of-arrays adjacency.
+ *
+ * The grid's vertices are added in random order, like the IDs of a real locations file.
+ *
+ * @param side The number of vertices on each side of the grid.
+ */
+void benchmarkPrefetch(const int side) {
+    Graph<int> grid;
+    mt19937 rng(2025);
+    uniform_int_distribution<int> minutes(1, 30);
+
+    const int n = side * side;
+    vector<int> order(n);
+    iota(order.begin(), order.end(), 0);
+    shuffle(order.begin(), order.end(), rng);
+    for (int id : order)
+        grid.addVertex("grid", id, "G" + to_string(id), false);
+    for (int r = 0; r < side; r++) {
+        for (int c = 0; c < side; c++) {
+            int id = r * side + c;
+            if (c + 1 < side) grid.addBidirectionalEdge(id, id + 1, minutes(rng), minutes(rng));
+            if (r + 1 < side) grid.addBidirectionalEdge(id, id + side, minutes(rng), minutes(rng));
+        }
+    }
+
+    vector<int> origins;
+    for (int i = 0; i < 4; i++)
+        origins.push_back(uniform_int_distribution<int>(0, n - 1)(rng));
+
+    cerr << "Prefetch benchmark: " << side << "x" << side << " grid, " << n << " vertices\n";
+    if (!setSearchPrefetch(true)) {
+        cerr << "  built without SEARCH_PREFETCH: nothing to compare\n";
+        return;
+    }
+
+    driving_dijkstra(&grid, origins[0]); // warm up: size the search arrays
+    for (int layout = 0; layout < 2; layout++) {
+        if (layout == 1) grid.buildSoAAdjacency();
+
+        for (int prefetch = 0; prefetch < 2; prefetch++) {
+            setSearchPrefetch(prefetch == 1);
+            auto start = chrono::steady_clock::now();
+            for (int origin : origins)
+                driving_dijkstra(&grid, origin);
+            double seconds = secondsSince(start);
+
+            cerr << "  " << (layout == 0 ? "plain" : "soa") << " adjacency, prefetch " << (prefetch ? "on" : "off")
+                 << ": " << seconds * 1e3 / origins.size() << " ms/search\n";
+        }
+    }
+    setSearchPrefetch(true);
+}
@@ -1,5 +1,4 @@
 #include <iostream>
-#include <fstream>
 #include <utility>
 
 #include "../data_structures/Graph.h"
@@ -13,23 +12,54 @@ using namespace std;
 /**
  * @brief Computes the best and alternative driving routes from an origin to a destination without any restrictions.
  *
+ * If the graph has an all-pairs driving table, the best route is looked up in it instead of searched for. Hub labels
+ * only serve the lookup of its time: they hold distances, not routes, so the route is still searched for, stopping
+ * at the destination (and not at all if the labels find it unreachable), which keeps it the one printed without
+ * labels on ties. With a tree cache, the search is complete instead, so that later queries from the same origin
+ * find it cached. The alternative route always takes a complete search, through the tree cache.
+ *
  * @param g The graph containing the vertices and edges.
  * @param origin The ID of the origin vertex.
  * @param dest The ID of the destination vertex.
- * @param batch If true, outputs the results to a file; otherwise, outputs to the console.
+ * @param out The stream the results are written to.
  */
-void driving_mode(Graph<int> *g, const int &origin, const int &dest, const bool batch) {
-
-    std::ofstream fout;
-    std::ostream& out = batch ? (fout.open("output.txt"), fout) : std::cout;
+void driving_mode(Graph<int> *g, const int &origin, const int &dest, ostream &out) {
 
     out << "Source:" << origin << '\n';
     out << "Destination:" << dest << '\n';
 
     setup(g);
 
-    driving_dijkstra(g, origin);
-    auto path = getPathDrive(g, origin, dest);
+    if (!mayDrive(g, g->findVertex(origin), g->findVertex(dest))) { // different components: no search needed
+        out << "BestDrivingRoute:none\n";
+        return;
+    }
+
+    auto &table = g->getDriveTable();
+    auto &labels = g->getDriveLabels();
+    vector<Vertex<int>*> path;
+    Distance best;
+
+    if (!table.empty()) { // precomputed: read the route backwards from the table
+        path = getPathTable(table, g->findVertex(origin), g->findVertex(dest));
+        best = table.getDist(path.front(), path.back());
+    } else if (!labels.empty()) { // labels give the time only: the route is searched, up to the destination
+        best = labels.query(g->findVertex(origin)->getIndex(), g->findVertex(dest)->getIndex());
+        if (best != INF) {
+            auto stop = makeTargets(g, {dest});
+            driving_dijkstra(g, g->getDriveTree(), origin, Restrictions::none(), &stop);
+        }
+        path = getPathDrive(g, origin, dest);
+    } else if (g->getTreeCache().enabled()) { // the whole tree, for later queries from the origin
+        cached_driving_dijkstra(g, origin);
+        path = getPathDrive(g, origin, dest);
+        best = g->getDriveTree().getDist(path.back());
+    } else { // only the route to the destination is needed: the search stops there (and follows its arc flags)
+        auto stop = makeTargets(g, {dest});
+        driving_dijkstra(g, g->getDriveTree(), origin, Restrictions::none(), &stop);
+        path = getPathDrive(g, origin, dest);
+        best = g->getDriveTree().getDist(path.back());
+    }
 
     if (path.empty() || path[0]->getID() == dest) {
         out << "BestDrivingRoute:none\n";
@@ -38,15 +68,17 @@ void driving_mode(Graph<int> *g, const int &origin, const int &dest, const bool
 
     out << "BestDrivingRoute:" << path[0]->getID();
 
-    for (int i = 1; i < path.size(); i++) {
+    Restrictions restrictions(g->getNumVertex(), g->getNumEdgeIndices()); // the alternative avoids the best route
+
+    for (size_t i = 1; i < path.size(); i++) {
         out << ',' << path[i]->getID();
-        path[i]->setRestricted(true);
+        restrictions.restrictVertex(path[i]->getIndex());
     }
 
-    path.back()->setRestricted(false);
-    out << '(' << path.back()->getDistDrive() << ')' << '\n';
+    restrictions.allowVertex(path.back()->getIndex());
+    out << '(' << best << ')' << '\n';
 
-    driving_dijkstra(g, origin);
+    cached_driving_dijkstra(g, origin, restrictions);
     path = getPathDrive(g, origin, dest);
 
     if (path.empty() || path[0]->getID() == dest) {
@@ -56,75 +88,107 @@ void driving_mode(Graph<int> *g, const int &origin, const int &dest, const bool
 
     out << "AlternativeDrivingRoute:" << path[0]->getID();
 
-    for (int i = 1; i < path.size(); i++) {
+    for (size_t i = 1; i < path.size(); i++) {
         out << ',' << path[i]->getID();
-        path[i]->setRestricted(true);
     }
 
-    path.back()->setRestricted(false);
-    out << '(' << path.back()->getDistDrive() << ')' << '\n';
+    out << '(' << g->getDriveTree().getDist(path.back()) << ')' << '\n';
 }
 
 // Driving Computation: with restrictions ------------------------------------------------------------------------------
 
 /**
- * @brief Computes the best driving route from an origin to a destination while avoiding specific nodes and edges, and optionally including a specific node.
+ * @brief Computes the best driving route from an origin to a destination while avoiding specific nodes and edges, and optionally including specific nodes.
+ *
+ * With stops to include, the legs are costed first, by one search from the origin and from each stop that ends once
+ * the stops it may lead to are settled (or from the all-pairs table, if nothing is avoided). In a fixed order that is
+ * the next stop; otherwise every stop, and the order is chosen from the table of legs (see orderWaypoints). Only the
+ * legs of that order are then read back from the searches. Without stops, the route comes from one complete search,
+ * through the graph's tree cache.
  *
  * @param g The graph containing the vertices and edges.
  * @param origin The ID of the origin vertex.
  * @param dest The ID of the destination vertex.
  * @param avoid_nodes A vector of node IDs to avoid in the route.
  * @param avoid_edges A vector of pairs representing edges to avoid in the route.
- * @param include_node The ID of a node that must be included in the route, or -1 if no such node is required.
- * @param batch If true, outputs the results to a file; otherwise, outputs to the console.
+ * @param waypoints The nodes that must be included in the route, and whether they may be reordered.
+ * @param out The stream the results are written to.
  */
-void driving_mode(Graph<int> *g, const int &origin, const int &dest, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, const int &include_node, const bool batch) {
-
-    std::ofstream fout;
-    std::ostream& out = batch ? (fout.open("output.txt"), fout) : std::cout;
+void driving_mode(Graph<int> *g, const int &origin, const int &dest, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, const Waypoints &waypoints, ostream &out) {
 
     out << "Source:" << origin << '\n';
     out << "Destination:" << dest << '\n';
 
     setup(g);
 
-    for (int an:avoid_nodes) {
-        auto v = g->findVertex(an);
-        v->setRestricted(true);
-    }
+    auto restrictions = makeRestrictions(g, avoid_nodes, avoid_edges);
+
+    if (!waypoints.nodes.empty()) {
+        vector<int> stops = {origin}; // the origin, the stops to include and the destination
+        stops.insert(stops.end(), waypoints.nodes.begin(), waypoints.nodes.end());
+        stops.push_back(dest);
+        const int m = stops.size();
 
-    for (auto p:avoid_edges) {
-        auto v = g->findVertex(p.first);
-        for (auto e:v->getAdj()) {
-            if (e->getDest()->getID() == p.second) {
-                e->setRestricted(true);
-                e->getReverse()->setRestricted(true);
+        for (int id:stops) {
+            if (!mayDrive(g, g->findVertex(origin), g->findVertex(id))) { // different components: no search needed
+                out << "RestrictedDrivingRoute:none\n";
+                return;
             }
         }
-    }
 
-    if (include_node != -1) {
-        vector<int> nodes = {origin, include_node, dest};
-        string res = "RestrictedDrivingRoute:";
-        double dist = 0;
+        // one search per stop but the last, kept until the route is read: in a fixed order it only needs the next
+        // stop, otherwise all of them
+        auto &table = g->getDriveTable();
+        const bool fromTable = restrictions.empty() && !table.empty();
+        vector<SearchTree<int>> trees(fromTable ? 0 : m - 1);
+
+        if (!fromTable) {
+            const auto all = makeTargets(g, stops);
+            parallelSearches(m - 1, 0, [&](int i, SearchTree<int> &, SearchTree<int> &) {
+                if (waypoints.optimise) {
+                    driving_dijkstra(g, trees[i], stops[i], restrictions, &all);
+                } else {
+                    auto next = makeTargets(g, {stops[i + 1]});
+                    driving_dijkstra(g, trees[i], stops[i], restrictions, &next);
+                }
+            });
+        }
+
+        auto legCost = [&](int i, int j) {
+            auto to = g->findVertex(stops[j]);
+            return fromTable ? table.getDist(g->findVertex(stops[i]), to) : trees[i].getDist(to);
+        };
+
+        vector<int> order(m);
+        for (int i = 0; i < m; i++)
+            order[i] = i;
+
+        if (waypoints.optimise) {
+            vector<vector<Distance>> cost(m, vector<Distance>(m, INF));
+            for (int i = 0; i < m - 1; i++)
+                for (int j = 0; j < m; j++)
+                    cost[i][j] = legCost(i, j);
+            order = orderWaypoints(cost);
+        }
+
+        string res = "RestrictedDrivingRoute:" + to_string(origin);
+        Distance dist = 0;
 
-        for (int i = 0; i < 2; i++) {
-            driving_dijkstra(g, nodes[i]);
-            auto path = getPathDrive(g, nodes[i], nodes[i+1]);
+        for (size_t l = 0; l + 1 < order.size(); l++) {
+            const int i = order[l], j = order[l + 1];
 
-            if (path.empty() || path[0]->getID() == dest) {
+            if (stops[i] == dest || legCost(i, j) == INF) { // leg end not reached
                 out << "RestrictedDrivingRoute:none\n";
                 return;
             }
 
-            if (path[0]->getID() != include_node)
-                res += to_string(path[0]->getID());
+            auto to = g->findVertex(stops[j]);
+            auto path = fromTable ? getPathTable(table, g->findVertex(stops[i]), to) : getPathTree(trees[i], to);
 
-            for (int j = 1; j < path.size(); j++)
-                res += "," + to_string(path[j]->getID());
+            for (size_t k = 1; k < path.size(); k++)
+                res += "," + to_string(path[k]->getID());
 
-
-            dist += path.back()->getDistDrive();
+            dist += legCost(i, j);
         }
 
         out << res << '(' << dist << ')' << '\n';
@@ -132,7 +196,12 @@ void driving_mode(Graph<int> *g, const int &origin, const int &dest, const vecto
 
     else {
 
-        driving_dijkstra(g, origin);
+        if (!mayDrive(g, g->findVertex(origin), g->findVertex(dest))) {
+            out << "RestrictedDrivingRoute:none\n";
+            return;
+        }
+
+        cached_driving_dijkstra(g, origin, restrictions);
         auto path = getPathDrive(g, origin, dest);
 
         if (path.empty() || path[0]->getID() == dest) {
@@ -142,10 +211,55 @@ void driving_mode(Graph<int> *g, const int &origin, const int &dest, const vecto
 
         out << "RestrictedDrivingRoute:" << path[0]->getID();
 
-        for (int i = 1; i < path.size(); i++) {
+        for (size_t i = 1; i < path.size(); i++) {
             out << ',' << path[i]->getID();
         }
 
-        out << '(' << path.back()->getDistDrive() << ')' << '\n';
+        out << '(' << g->getDriveTree().getDist(path.back()) << ')' << '\n';
+    }
+}
+
+// Driving Computation: k shortest routes ------------------------------------------------------------------------------
+
+/**
+ * @brief Computes the k fastest loopless driving routes from an origin to a destination while avoiding specific nodes and edges.
+ *
+ * The routes are written as DrivingRoute1 to DrivingRouteK, fastest first; there may be fewer if the graph has no
+ * more. The spur searches behind each route run in parallel (see kShortestDrive).
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param k The number of routes wanted.
+ * @param avoid_nodes A vector of node IDs to avoid in the routes.
+ * @param avoid_edges A vector of pairs representing edges to avoid in the routes.
+ * @param out The stream the results are written to.
+ */
+void k_shortest_mode(Graph<int> *g, const int &origin, const int &dest, const int k, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, ostream &out) {
+
+    out << "Source:" << origin << '\n';
+    out << "Destination:" << dest << '\n';
+
+    setup(g);
+
+    if (origin == dest || !mayDrive(g, g->findVertex(origin), g->findVertex(dest))) {
+        out << "DrivingRoute1:none\n";
+        return;
+    }
+
+    auto routes = kShortestDrive(g, origin, dest, k, makeRestrictions(g, avoid_nodes, avoid_edges));
+
+    if (routes.empty()) {
+        out << "DrivingRoute1:none\n";
+        return;
+    }
+
+    for (size_t i = 0; i < routes.size(); i++) {
+        out << "DrivingRoute" << i + 1 << ':' << routes[i].vertices[0]->getID();
+
+        for (size_t j = 1; j < routes[i].vertices.size(); j++)
+            out << ',' << routes[i].vertices[j]->getID();
+
+        out << '(' << routes[i].cost << ')' << '\n';
     }
 }
@@ -1,11 +1,118 @@
 #include <iostream>
-#include <fstream>
 
 #include "../headers/driving_walking.h"
 #include "../headers/algorithms.h"
 
 using namespace std;
 
+// Auxiliary functions for the parking scans ---------------------------------------------------------------------------
+
+/**
+ * @brief Computes the total time of driving from the origin to a parking vertex and walking from it to the destination.
+ *
+ * @param drive The driving search tree (rooted at the origin).
+ * @param walk The walking search tree (rooted at the destination).
+ * @param v The parking vertex.
+ * @return The sum of both distances, or INF if the vertex is unreachable by either mode.
+ */
+Distance totalTime(const SearchTree<int> &drive, const SearchTree<int> &walk, const Vertex<int> *v) {
+    if (drive.getDist(v) == INF || walk.getDist(v) == INF)
+        return INF;
+    return drive.getDist(v) + walk.getDist(v);
+}
+
+/**
+ * @brief Cheap precheck for the eco modes: tells whether some parking vertex may be driven to from the origin
+ * and walked from to the destination, using the component labels instead of searching.
+ *
+ * @param g The graph containing the vertices.
+ * @param restrictions The restrictions of the query (restricted vertices cannot be parked at).
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param parkAtDest Whether the destination itself may be the parking vertex.
+ * @return false only if no parking vertex can be part of a route.
+ */
+bool mayPark(Graph<int> *g, const Restrictions &restrictions, const int &origin, const int &dest, const bool parkAtDest) {
+    auto o = g->findVertex(origin), d = g->findVertex(dest);
+    if (!g->hasComponents() || o == nullptr || d == nullptr) return true;
+
+    for (auto v:g->getVertexSet()) {
+        if (v->hasParking() && v != o && (parkAtDest || v != d) && !restrictions.isVertexRestricted(v->getIndex())
+            && mayDrive(g, o, v) && mayWalk(g, v, d))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Fills the driving tree from the origin and the walking tree from the destination.
+ *
+ * Without restrictions, and if the graph has all-pairs tables, the rows of both ends are copied instead of searched;
+ * otherwise both searches run at once, each through the graph's tree cache.
+ *
+ * @param g The graph containing the vertices.
+ * @param restrictions The restrictions of the query.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ */
+void searchFromEnds(Graph<int> *g, const Restrictions &restrictions, const int &origin, const int &dest) {
+    if (restrictions.empty() && !g->getDriveTable().empty()) {
+        g->getDriveTable().load(g->findVertex(origin)->getIndex(), g->getDriveTree());
+        g->getWalkTable().load(g->findVertex(dest)->getIndex(), g->getWalkTree());
+        return;
+    }
+
+    driving_walking_dijkstra(g, origin, restrictions, dest, restrictions);
+}
+
+/**
+ * @brief Picks the parking vertex of an unrestricted eco query from the graph's parking index.
+ *
+ * The candidates are the destination's entries within the walking limit. Only the driving search runs, and it stops
+ * once every candidate is settled or none left can beat the best total so far. Ties are broken as in the scan over
+ * all vertices: the longer walk wins, and then the lower index.
+ *
+ * @param g The graph containing the vertices, with a parking index covering the walking limit.
+ * @param origin The ID of the origin vertex.
+ * @param dest The ID of the destination vertex.
+ * @param max_walk_time The maximum allowed walking time in minutes.
+ * @return The parking vertex (with its driving route in the driving tree), or nullptr if no candidate can be driven to.
+ */
+Vertex<int> *parkFromIndex(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time) {
+    auto o = g->findVertex(origin), d = g->findVertex(dest);
+    const auto candidates = g->getParkingIndex().candidates(d->getIndex());
+
+    vector<int> ids;
+    vector<Distance> walks;
+    for (auto [p, time] : candidates) {
+        if (time <= max_walk_time && g->getVertex(p) != o) {
+            ids.push_back(g->getVertex(p)->getID());
+            walks.push_back(time);
+        }
+    }
+    if (ids.empty()) return nullptr;
+
+    // the walks are the exit costs: the search also stops once no candidate left can beat the best total so far
+    auto &drive = g->getDriveTree();
+    auto stop = makeTargets(g, ids, walks);
+    driving_dijkstra(g, drive, origin, Restrictions::none(), &stop);
+
+    Vertex<int> *park = nullptr;
+    Distance best_time = INF, best_walk = 0;
+    for (auto [p, time] : candidates) {
+        auto v = g->getVertex(p);
+        if (time > max_walk_time || v == o || drive.getDist(v) == INF) continue;
+
+        Distance total = drive.getDist(v) + time;
+        if (total < best_time || (total == best_time && (time > best_walk || (time == best_walk && p < park->getIndex())))) {
+            best_time = total;
+            best_walk = time;
+            park = v;
+        }
+    }
+    return park;
+}
+
 // Eco-mode ------------------------------------------------------------------------------------------------------------
 
 /**
@@ -13,6 +120,10 @@ using namespace std;
  *
  * This function calculates the optimal route by driving to a parking node and then walking to the destination,
  * while respecting constraints such as maximum walking time and avoiding specific nodes and edges.
+ * With a parking index covering the walking limit and no restrictions, the candidates come from it and only the
+ * driving search runs (see parkFromIndex). Otherwise, with hub labels and no restrictions, the parking vertices are
+ * costed from the labels, and only the two routes through the chosen one are searched. Large graphs get the same
+ * treatment with parallel delta-stepping distances.
  *
  * @param g The graph containing the vertices and edges.
  * @param origin The ID of the origin vertex.
@@ -20,52 +131,68 @@ using namespace std;
  * @param max_walk_time The maximum allowed walking time in minutes.
  * @param avoid_nodes A vector of node IDs to avoid in the route.
  * @param avoid_edges A vector of pairs representing edges to avoid in the route.
- * @param batch Specifies if the function has been called on batch mode or manual mode.
+ * @param out The stream the results are written to.
  */
-void eco_mode(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, bool batch) {
-
-    std::ofstream fout;
-    std::ostream& out = batch ? (fout.open("output.txt"), fout) : cout;
+void eco_mode(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, ostream &out) {
 
     setup(g);
 
-    for (int an:avoid_nodes) {
-        auto v = g->findVertex(an);
-        v->setRestricted(true);
-    }
+    auto &drive = g->getDriveTree();
+    auto &walk = g->getWalkTree();
 
-    for (auto p:avoid_edges) {
-        auto v = g->findVertex(p.first);
-        for (auto e:v->getAdj()) {
-            if (e->getDest()->getID() == p.second) {
-                e->setRestricted(true);
-                e->getReverse()->setRestricted(true);
-            }
-        }
-    }
+    auto restrictions = makeRestrictions(g, avoid_nodes, avoid_edges);
 
-    driving_dijkstra(g, origin);
+    const bool parkable = mayPark(g, restrictions, origin, dest, true); // otherwise the trees stay unreached: "No path"
 
-    for (auto v:g->getVertexSet()) {
-        v->setWalking(true);
+    // with a parking index (and nothing restricted), the candidates are read from it; if none can be used, the
+    // query goes on without it, which also tells why
+    const auto &parkingIndex = g->getParkingIndex();
+    Vertex<int> *park = nullptr;
+    if (parkable && restrictions.empty() && g->getDriveTable().empty() && !parkingIndex.empty() && max_walk_time <= parkingIndex.budget())
+        park = parkFromIndex(g, origin, dest, max_walk_time);
+    const bool indexed = park != nullptr;
+
+    // with hub labels (and nothing restricted), each parking vertex is costed from the labels instead of full trees;
+    // on large graphs, from distances computed in parallel
+    const bool labelled = parkable && !indexed && restrictions.empty() && g->getDriveTable().empty() && !g->getDriveLabels().empty();
+    const bool parallel = parkable && !indexed && !labelled && g->getDriveTable().empty() && useDeltaStepping(g);
+
+    vector<Distance> driveDist, walkDist;
+    if (parallel) {
+        driveDist = driving_delta_stepping(g, origin, restrictions);
+        walkDist = walking_delta_stepping(g, dest, restrictions);
+    } else if (parkable && !indexed && !labelled) {
+        searchFromEnds(g, restrictions, origin, dest);
     }
 
-    walking_dijkstra(g, dest);
-
-    double best_time = INF;
-    Vertex<int> *park = nullptr;
+    auto o = g->findVertex(origin), d = g->findVertex(dest);
+    auto driveCost = [&](const Vertex<int> *v) {
+        if (labelled) return g->getDriveLabels().query(o->getIndex(), v->getIndex());
+        return parallel ? driveDist[v->getIndex()] : drive.getDist(v);
+    };
+    auto walkCost = [&](const Vertex<int> *v) { // from the destination, like the walking tree
+        if (labelled) return g->getWalkLabels().query(d->getIndex(), v->getIndex());
+        return parallel ? walkDist[v->getIndex()] : walk.getDist(v);
+    };
+    auto total = [&](const Vertex<int> *v) {
+        return driveCost(v) == INF || walkCost(v) == INF ? INF : driveCost(v) + walkCost(v);
+    };
+
+    Distance best_time = INF;
     bool no_path = true;
 
-    for (auto v:g->getVertexSet()) {
-        if (v->hasParking() && v->getDistWalk() <= max_walk_time && !v->isRestricted() && v->getID() != origin) {
-            if (v->getDistWalk() + v->getDistDrive() < best_time || (v->getDistWalk() + v->getDistDrive() == best_time && v->getDistWalk() > park->getDistWalk())) {
-                best_time = v->getDistWalk() + v->getDistDrive();
-                park = v;
+    if (!indexed) {
+        for (auto v:g->getVertexSet()) {
+            if (v->hasParking() && walkCost(v) <= max_walk_time && !restrictions.isVertexRestricted(v->getIndex()) && v->getID() != origin) {
+                if (total(v) < best_time || (best_time != INF && total(v) == best_time && walkCost(v) > walkCost(park))) {
+                    best_time = total(v);
+                    park = v;
+                }
             }
-        }
 
-        if (v->hasParking() && v->getPathWalk() != nullptr && v->getPathDrive() != nullptr)
-            no_path = false;
+            if (v->hasParking() && v != o && v != d && driveCost(v) != INF && walkCost(v) != INF) // reached by both trees
+                no_path = false;
+        }
     }
 
     out << "Source:" << origin << '\n';
@@ -84,6 +211,14 @@ void eco_mode(Graph<int> *g, const int &origin, const int &dest, const double &m
     }
 
     else {
+        if (indexed) { // the driving route is already in the tree
+            auto stop = makeTargets(g, {park->getID()});
+            walking_dijkstra(g, walk, dest, restrictions, &stop);
+        } else if (labelled || parallel) { // only the routes to and from the chosen parking vertex are searched
+            auto stop = makeTargets(g, {park->getID()});
+            driving_walking_dijkstra(g, origin, restrictions, dest, restrictions, &stop);
+        }
+
         auto pathDrive = getPathDrive(g, origin, park->getID());
         auto pathWalk = getPathWalk(g, dest, park->getID());
 
@@ -92,22 +227,19 @@ void eco_mode(Graph<int> *g, const int &origin, const int &dest, const double &m
         for (int i = 1; i < pathDrive.size(); i++)
             out << ',' << pathDrive[i]->getID();
 
-        out << '(' << pathDrive.back()->getDistDrive() << ")\n";
+        out << '(' << drive.getDist(pathDrive.back()) << ")\n";
 
         out << "ParkingNode:" << pathWalk.back()->getID() << '\n';
 
         out << "WalkingRoute:" << pathWalk.back()->getID();
 
-        for (double i = pathWalk.size() - 2; i >= 0; i--)
+        // back from the parking vertex; parking at the destination leaves just the destination, and nothing to add
+        for (size_t i = pathWalk.size() - 1; i-- > 0; )
             out << ',' << pathWalk[i]->getID();
 
-        out << '(' << pathWalk.back()->getDistWalk() << ")\n";
+        out << '(' << walk.getDist(pathWalk.back()) << ")\n";
 
-        out << "TotalTime:" << pathDrive.back()->getDistDrive() + pathWalk.back()->getDistWalk() << '\n';
-    }
-
-    for (auto v:g->getVertexSet()) {
-        v->setWalking(false);
+        out << "TotalTime:" << drive.getDist(pathDrive.back()) + walk.getDist(pathWalk.back()) << '\n';
     }
 }
 
@@ -126,55 +258,33 @@ void eco_mode(Graph<int> *g, const int &origin, const int &dest, const double &m
  * @param max_walk_time The maximum allowed walking time in minutes.
  * @param avoid_nodes A vector of node IDs to avoid in the route.
  * @param avoid_edges A vector of pairs representing edges to avoid in the route.
- * @param batch Specifies if the function has been called on batch mode or manual mode.
+ * @param out The stream the results are written to.
  */
-void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, bool batch) {
-
-    std::ofstream fout;
-    std::ostream& out = batch ? (fout.open("output.txt"), fout) : cout;
+void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, const double &max_walk_time, const vector<int> &avoid_nodes, const vector<pair<int,int>> &avoid_edges, ostream &out) {
 
     setup(g);
 
-    for (int an:avoid_nodes) {
-        auto v = g->findVertex(an);
-        v->setRestricted(true);
-    }
+    auto &drive = g->getDriveTree();
+    auto &walk = g->getWalkTree();
 
-    for (auto p:avoid_edges) {
-        auto v = g->findVertex(p.first);
-        for (auto e:v->getAdj()) {
-            if (e->getDest()->getID() == p.second) {
-                e->setRestricted(true);
-                e->getReverse()->setRestricted(true);
-            }
-        }
-    }
-
-    driving_dijkstra(g, origin);
-
-    for (auto v:g->getVertexSet()) {
-        v->setWalking(true);
-    }
+    auto restrictions = makeRestrictions(g, avoid_nodes, avoid_edges);
 
-    walking_dijkstra(g, dest);
+    if (mayPark(g, restrictions, origin, dest, false)) // otherwise the trees stay unreached: "No path"
+        searchFromEnds(g, restrictions, origin, dest);
 
-    for (auto v:g->getVertexSet()) {
-        v->setWalking(false);
-    }
-
-    double best_time = INF;
+    Distance best_time = INF;
     Vertex<int> *park = nullptr;
     bool no_path = true;
 
     for (auto v:g->getVertexSet()) {
-        if (v->hasParking() && v->getDistWalk() <= max_walk_time && !v->isRestricted() && v->getID() != origin && v->getID() != dest) {
-            if (v->getDistWalk() + v->getDistDrive() < best_time || (best_time != INF && v->getDistWalk() + v->getDistDrive() == best_time && v->getDistWalk() > park->getDistWalk())) {
-                best_time = v->getDistWalk() + v->getDistDrive();
+        if (v->hasParking() && walk.getDist(v) <= max_walk_time && !restrictions.isVertexRestricted(v->getIndex()) && v->getID() != origin && v->getID() != dest) {
+            if (totalTime(drive, walk, v) < best_time || (best_time != INF && totalTime(drive, walk, v) == best_time && walk.getDist(v) > walk.getDist(park))) {
+                best_time = totalTime(drive, walk, v);
                 park = v;
             }
         }
 
-        if (v->hasParking() && v->getPathWalk() != nullptr && v->getPathDrive() != nullptr)
+        if (v->hasParking() && walk.getPath(v) != nullptr && drive.getPath(v) != nullptr)
             no_path = false;
     }
 
@@ -184,9 +294,9 @@ void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, con
     if (park == nullptr) {
         if(!no_path) {
             for (auto v:g->getVertexSet()) {
-                if (v->hasParking() && !v->isRestricted() && v->getID() != origin && v->getID() != dest) {
-                    if (v->getDistWalk() + v->getDistDrive() < best_time || (best_time != INF && v->getDistWalk() + v->getDistDrive() == best_time && v->getDistWalk() > park->getDistWalk())) {
-                        best_time = v->getDistWalk() + v->getDistDrive();
+                if (v->hasParking() && !restrictions.isVertexRestricted(v->getIndex()) && v->getID() != origin && v->getID() != dest) {
+                    if (totalTime(drive, walk, v) < best_time || (best_time != INF && totalTime(drive, walk, v) == best_time && walk.getDist(v) > walk.getDist(park))) {
+                        best_time = totalTime(drive, walk, v);
                         park = v;
                     }
                 }
@@ -200,59 +310,51 @@ void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, con
             for (int i = 1; i < pathDrive.size(); i++)
                 out << ',' << pathDrive[i]->getID();
 
-            out << '(' << pathDrive.back()->getDistDrive() << ")\n";
+            out << '(' << drive.getDist(pathDrive.back()) << ")\n";
 
             out << "ParkingNode1:" << pathWalk.back()->getID() << '\n';
 
             out << "WalkingRoute1:" << pathWalk.back()->getID();
 
-            for (double i = pathWalk.size() - 2; i >= 0; i--)
+            // back from the parking vertex; parking at the destination leaves just the destination, and nothing to add
+            for (size_t i = pathWalk.size() - 1; i-- > 0; )
                 out << ',' << pathWalk[i]->getID();
 
-            out << '(' << pathWalk.back()->getDistWalk() << ")\n";
+            out << '(' << walk.getDist(pathWalk.back()) << ")\n";
 
-            out << "TotalTime1:" << pathDrive.back()->getDistDrive() + pathWalk.back()->getDistWalk() << '\n';
+            out << "TotalTime1:" << drive.getDist(pathDrive.back()) + walk.getDist(pathWalk.back()) << '\n';
 
-            double best_time2 = INF;
-            double best_drive;
-            double best_walk;
+            Distance best_time2 = INF;
+            Distance best_drive;
+            Distance best_walk;
             Vertex<int> *park2 = nullptr;
             bool no_path2 = true;
             vector<Vertex<int>*> pathDrive2 = {};
             vector<Vertex<int>*> pathWalk2 = {};
+            Restrictions detour = restrictions; // the restrictions plus the route edge being avoided
 
             for (int i = 0; i < pathDrive.size() - 1; i++) {
                 for (auto e:pathDrive[i]->getAdj()) {
-                    if (e->getDest() == pathDrive[i+1]) {
-                        e->setRestricted(true);
+                    if (e->getOther(pathDrive[i]) == pathDrive[i+1]) {
+                        detour.restrictEdge(e->getIndex());
 
-                        driving_dijkstra(g, origin);
+                        driving_walking_dijkstra(g, origin, detour, dest, restrictions);
 
-                        e->setRestricted(false);
+                        detour.allowEdge(e->getIndex());
 
                         for (auto v:g->getVertexSet()) {
-                            v->setWalking(true);
-                        }
-
-                        walking_dijkstra(g, dest);
-
-                        for (auto v:g->getVertexSet()) {
-                            v->setWalking(false);
-                        }
-
-                        for (auto v:g->getVertexSet()) {
-                            if (v->hasParking() && !v->isRestricted() && v->getID() != origin && v->getID() != dest) {
-                                if (v->getDistWalk() + v->getDistDrive() < best_time2 || (best_time2 != INF && v->getDistWalk() + v->getDistDrive() == best_time2 && v->getDistWalk() > park->getDistWalk())) {
-                                    best_time2 = v->getDistWalk() + v->getDistDrive();
-                                    best_drive = v->getDistDrive();
-                                    best_walk = v->getDistWalk();
+                            if (v->hasParking() && !restrictions.isVertexRestricted(v->getIndex()) && v->getID() != origin && v->getID() != dest) {
+                                if (totalTime(drive, walk, v) < best_time2 || (best_time2 != INF && totalTime(drive, walk, v) == best_time2 && walk.getDist(v) > walk.getDist(park))) {
+                                    best_time2 = totalTime(drive, walk, v);
+                                    best_drive = drive.getDist(v);
+                                    best_walk = walk.getDist(v);
                                     park2 = v;
                                     pathDrive2 = getPathDrive(g, origin, park2->getID());
                                     pathWalk2 = getPathWalk(g, dest, park2->getID());
                                 }
                             }
 
-                            if (v->hasParking() && v->getPathWalk() != nullptr && v->getPathDrive() != nullptr)
+                            if (v->hasParking() && walk.getPath(v) != nullptr && drive.getPath(v) != nullptr)
                                 no_path2 = false;
                         }
                         break;
@@ -260,37 +362,28 @@ void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, con
                 }
             }
 
-            for (int i = 0; i < pathWalk.size() - 1; i++) {
+            for (size_t i = 0; i + 1 < pathWalk.size(); i++) {
                 for (auto e:pathWalk[i]->getAdj()) {
-                    if (e->getDest() == pathWalk[i+1]) {
-                        driving_dijkstra(g, origin);
-                        for (auto v:g->getVertexSet()) {
-                            v->setWalking(true);
-                        }
-
-                        e->setRestricted(true);
-
-                        walking_dijkstra(g, dest);
+                    if (e->getOther(pathWalk[i]) == pathWalk[i+1]) {
+                        detour.restrictEdge(e->getIndex());
 
-                        e->setRestricted(false);
+                        driving_walking_dijkstra(g, origin, restrictions, dest, detour);
 
-                        for (auto v:g->getVertexSet()) {
-                            v->setWalking(false);
-                        }
+                        detour.allowEdge(e->getIndex());
 
                         for (auto v:g->getVertexSet()) {
-                            if (v->hasParking() && !v->isRestricted() && v->getID() != origin && v->getID() != dest) {
-                                if (v->getDistWalk() + v->getDistDrive() < best_time2 || (best_time2 != INF && v->getDistWalk() + v->getDistDrive() == best_time2 && v->getDistWalk() > park->getDistWalk())) {
-                                    best_time2 = v->getDistWalk() + v->getDistDrive();
-                                    best_drive = v->getDistDrive();
-                                    best_walk = v->getDistWalk();
+                            if (v->hasParking() && !restrictions.isVertexRestricted(v->getIndex()) && v->getID() != origin && v->getID() != dest) {
+                                if (totalTime(drive, walk, v) < best_time2 || (best_time2 != INF && totalTime(drive, walk, v) == best_time2 && walk.getDist(v) > walk.getDist(park))) {
+                                    best_time2 = totalTime(drive, walk, v);
+                                    best_drive = drive.getDist(v);
+                                    best_walk = walk.getDist(v);
                                     park2 = v;
                                     pathDrive2 = getPathDrive(g, origin, park2->getID());
                                     pathWalk2 = getPathWalk(g, dest, park2->getID());
                                 }
                             }
 
-                            if (v->hasParking() && v->getPathWalk() != nullptr && v->getPathWalk() != nullptr)
+                            if (v->hasParking() && walk.getPath(v) != nullptr && walk.getPath(v) != nullptr)
                                 no_path2 = false;
                         }
                         break;
@@ -310,7 +403,7 @@ void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, con
 
                 out << "WalkingRoute2:" << pathWalk2.back()->getID();
 
-                for (double j = pathWalk2.size() - 2; j >= 0; j--)
+                for (size_t j = pathWalk2.size() - 1; j-- > 0; )
                     out << ',' << pathWalk2[j]->getID();
 
                 out << '(' << best_walk << ")\n";
@@ -351,7 +444,7 @@ void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, con
         for (int i = 1; i < pathDrive.size(); i++)
             out << ',' << pathDrive[i]->getID();
 
-        out << '(' << pathDrive.back()->getDistDrive() << ")\n";
+        out << '(' << drive.getDist(pathDrive.back()) << ")\n";
 
         out << "ParkingNode:" << pathWalk.back()->getID() << '\n';
 
@@ -360,8 +453,8 @@ void eco_mode_approximate(Graph<int> *g, const int &origin, const int &dest, con
         for (int i = pathWalk.size() - 2; i >= 0; i--)
             out << ',' << pathWalk[i]->getID();
 
-        out << '(' << pathWalk.back()->getDistWalk() << ")\n";
+        out << '(' << walk.getDist(pathWalk.back()) << ")\n";
 
-        out << "TotalTime:" << pathDrive.back()->getDistDrive() + pathWalk.back()->getDistWalk() << '\n';
+        out << "TotalTime:" << drive.getDist(pathDrive.back()) + walk.getDist(pathWalk.back()) << '\n';
     }
 }
\ No newline at end of file
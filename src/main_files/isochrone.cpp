@@ -0,0 +1,82 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+#include "../headers/isochrone.h"
+
+using namespace std;
+
+// Isochrone Computation -----------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes, for every source, the vertices reachable within the budget and the time to reach them.
+ *
+ * Each search is bounded by the budget (see boundedSearch), so it never expands past it. In eco, the driving search
+ * is followed by one walking search, bounded by the maximum walking time, from every parking vertex it reaches; a
+ * vertex then costs its cheapest drive plus walk. The sources are spread over the hardware threads.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param query The sources, metric and budgets.
+ * @param avoid_nodes A vector of node IDs the trips may not go through.
+ * @param avoid_edges A vector of pairs representing edges the trips may not use.
+ * @param batch If true, outputs the vertices to output.txt; otherwise, to the console.
+ */
+void isochrone_mode(Graph<int> *g, const IsochroneQuery &query, const vector<int> &avoid_nodes,
+                    const vector<pair<int,int>> &avoid_edges, const bool batch) {
+
+    vector<Vertex<int>*> sources;
+    for (int id:query.sources) {
+        sources.push_back(g->findVertex(id));
+        if (sources.back() == nullptr) {
+            cerr << "Invalid source in isochrone (" << id << ").\n";
+            return;
+        }
+    }
+
+    std::ofstream fout;
+    std::ostream& out = batch ? (fout.open("output.txt"), fout) : cout;
+
+    const char *metric = query.metric == IsochroneMetric::Driving ? "driving"
+                       : query.metric == IsochroneMetric::Walking ? "walking" : "eco";
+    out << "Source,Metric,Vertex,Time\n";
+
+    const auto restrictions = makeRestrictions(g, avoid_nodes, avoid_edges);
+    const int block = 256; // sources per parallel block: bounds the buffered sets
+    vector<vector<pair<Vertex<int>*, Distance>>> reached(block);
+
+    for (size_t first = 0; first < sources.size(); first += block) {
+        const int rows = min<size_t>(block, sources.size() - first);
+
+        parallelSearches(rows, 0, [&](int i, SearchTree<int> &, SearchTree<int> &) {
+            auto origin = sources[first + i];
+            auto &set = reached[i];
+
+            if (query.metric != IsochroneMetric::Eco) {
+                set = boundedSearch(g, query.metric == IsochroneMetric::Driving, origin, query.budget, restrictions);
+            } else {
+                vector<Distance> best(g->getNumVertex(), INF);
+                vector<Vertex<int>*> touched;
+                for (auto [park, drive] : boundedSearch(g, true, origin, query.budget, restrictions)) {
+                    if (!park->hasParking() || restrictions.isVertexRestricted(park->getIndex())) continue;
+                    for (auto [v, walk] : boundedSearch(g, false, park, query.walkBudget, restrictions)) {
+                        if (best[v->getIndex()] == INF) touched.push_back(v);
+                        best[v->getIndex()] = min(best[v->getIndex()], drive + walk);
+                    }
+                }
+                set.clear();
+                for (auto v:touched)
+                    set.emplace_back(v, best[v->getIndex()]);
+            }
+
+            sort(set.begin(), set.end(), [](const auto &a, const auto &b) {
+                return a.second != b.second ? a.second < b.second : a.first->getIndex() < b.first->getIndex();
+            });
+        });
+
+        for (int i = 0; i < rows; i++)
+            for (auto [v, time] : reached[i])
+                out << query.sources[first + i] << ',' << metric << ',' << v->getID() << ',' << time << '\n';
+    }
+
+    out.flush();
+}
@@ -0,0 +1,140 @@
+#include <iostream>
+#include <fstream>
+#include <algorithm>
+
+#include "../headers/matrix.h"
+#include "../headers/algorithms.h"
+
+using namespace std;
+
+// Matrix Computation --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes the driving and walking costs from every source to every target, without restrictions.
+ *
+ * Each source gets one driving and one walking search, which stop as soon as every target is settled; the searches
+ * run in parallel a block of sources at a time, and each block is written as soon as it is done. If the graph has
+ * all-pairs tables, the costs are read from them instead.
+ *
+ * @param g The graph containing the vertices and edges.
+ * @param query The sources, targets and output format.
+ * @param batch If true, outputs the table to output.txt (CSV) or output.bin (binary); otherwise, to the console.
+ */
+void matrix_mode(Graph<int> *g, const MatrixQuery &query, const bool batch) {
+
+    vector<Vertex<int>*> sources, targets;
+    for (int id:query.sources) {
+        sources.push_back(g->findVertex(id));
+        if (sources.back() == nullptr) {
+            cerr << "Invalid source in matrix (" << id << ").\n";
+            return;
+        }
+    }
+    for (int id:query.targets) {
+        targets.push_back(g->findVertex(id));
+        if (targets.back() == nullptr) {
+            cerr << "Invalid target in matrix (" << id << ").\n";
+            return;
+        }
+    }
+
+    const bool binary = query.format == MatrixFormat::Binary;
+    std::ofstream fout;
+    std::ostream& out = batch ? (fout.open(binary ? "output.bin" : "output.txt", binary ? ios::binary : ios::out), fout) : cout;
+
+    writeMatrixHeader(out, query);
+
+    const auto stop = makeTargets(g, query.targets);
+    const auto &driveTable = g->getDriveTable();
+    const auto &walkTable = g->getWalkTable();
+
+    const size_t cols = targets.size();
+    const int block = 256; // sources per parallel block: bounds the buffered rows
+    vector<Distance> drive(block * cols), walk(block * cols);
+
+    for (size_t first = 0; first < sources.size(); first += block) {
+        const int rows = min<size_t>(block, sources.size() - first);
+
+        parallelSearches(rows, 0, [&](int i, SearchTree<int> &driveTree, SearchTree<int> &walkTree) {
+            auto origin = sources[first + i];
+            auto driveRow = drive.begin() + i * cols, walkRow = walk.begin() + i * cols;
+
+            if (!driveTable.empty()) {
+                for (size_t j = 0; j < cols; j++) {
+                    driveRow[j] = driveTable.getDist(origin, targets[j]);
+                    walkRow[j] = walkTable.getDist(origin, targets[j]);
+                }
+                return;
+            }
+
+            driving_dijkstra(g, driveTree, origin->getID(), Restrictions::none(), &stop);
+            walking_dijkstra(g, walkTree, origin->getID(), Restrictions::none(), &stop);
+            for (size_t j = 0; j < cols; j++) {
+                driveRow[j] = driveTree.getDist(targets[j]);
+                walkRow[j] = walkTree.getDist(targets[j]);
+            }
+        });
+
+        for (int i = 0; i < rows; i++) {
+            int source = query.sources[first + i];
+            writeMatrixRow(out, query.format, source, "driving", span<const Distance>(drive).subspan(i * cols, cols));
+            writeMatrixRow(out, query.format, source, "walking", span<const Distance>(walk).subspan(i * cols, cols));
+        }
+    }
+
+    out.flush();
+}
+
+// Matrix Output -------------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Writes the start of the table.
+ *
+ * CSV: "Source,Metric" followed by the target IDs. Binary: the bytes "DAMX", the number of sources and of targets
+ * (uint32), the source IDs and the target IDs (int32); the rows follow, each source's driving row then its walking
+ * row (uint32 per target, 4294967295 if unreachable).
+ *
+ * @param out The stream to write to.
+ * @param query The query whose table is written.
+ */
+void writeMatrixHeader(std::ostream &out, const MatrixQuery &query) {
+    if (query.format == MatrixFormat::Binary) {
+        uint32_t rows = query.sources.size(), cols = query.targets.size();
+        out.write("DAMX", 4);
+        out.write(reinterpret_cast<const char *>(&rows), sizeof(rows));
+        out.write(reinterpret_cast<const char *>(&cols), sizeof(cols));
+        out.write(reinterpret_cast<const char *>(query.sources.data()), rows * sizeof(int32_t));
+        out.write(reinterpret_cast<const char *>(query.targets.data()), cols * sizeof(int32_t));
+        return;
+    }
+
+    out << "Source,Metric";
+    for (int id:query.targets)
+        out << ',' << id;
+    out << '\n';
+}
+
+/**
+ * @brief Writes the costs from one source to every target for one metric.
+ *
+ * In CSV, unreachable targets are written as "X", as in the distances file.
+ *
+ * @param out The stream to write to.
+ * @param format The encoding of the table.
+ * @param source The ID of the source.
+ * @param metric The name of the metric ("driving" or "walking"), for CSV.
+ * @param costs The cost to each target, in the order of the query.
+ */
+void writeMatrixRow(std::ostream &out, MatrixFormat format, int source, const char *metric, std::span<const Distance> costs) {
+    if (format == MatrixFormat::Binary) {
+        out.write(reinterpret_cast<const char *>(costs.data()), costs.size_bytes());
+        return;
+    }
+
+    out << source << ',' << metric;
+    for (auto d:costs) {
+        if (d == INF) out << ",X";
+        else out << ',' << d;
+    }
+    out << '\n';
+}
@@ -1,10 +1,18 @@
 #include <iostream>
+#include <fstream>
+#include <sstream>
 
 #include "../data_structures/Graph.h"
 #include "../headers/parsing.h"
 #include "../headers/driving.h"
 #include "../headers/driving_walking.h"
 #include "../headers/modes.h"
+#include "../headers/alloc_counter.h"
+#include "../headers/preprocessing.h"
+#include "../headers/benchmarks.h"
+#include "../headers/matrix.h"
+#include "../headers/isochrone.h"
+#include "../headers/batch.h"
 
 using namespace std;
 
@@ -15,7 +23,10 @@ using namespace std;
  *
  * This function reads the graph data from location and distance files, processes the input file to determine
  * the source, destination, and constraints, and then computes the optimal route based on the specified mode
- * (driving or eco mode).
+ * (driving, eco, matrix or isochrone mode).
+ *
+ * The input file may hold several driving and eco queries, separated by "---" lines; load options apply to all of
+ * them. They are then answered by runBatch, grouped by the search trees they share.
  *
  * Input format: ./DA_PROJ1 <locations file> <distances file> <input file> <something>
  * Note: the last argument can be anything, only the number of arguments is relevant for this function.
@@ -24,7 +35,8 @@ using namespace std;
  * @param argc Number of command line arguments.
  */
 void batchMode(char *argv[], int argc) {
-    auto *g = new Graph<int>();
+    Graph<int> graph;
+    Graph<int> *g = &graph;
     const string locations_file = argv[1];
     const string distances_file = argv[2];
     const string input_file = argv[3];
@@ -40,40 +52,64 @@ void batchMode(char *argv[], int argc) {
 
     if (!parseDistances(g, distances_file)) return;
 
-    int src, dest, inc_n = -1, maxWalkTime;
-    bool driving, restricted = false;
-    vector<int> avoid_n;
-    vector<pair<int,int>> avoid_seg;
-
     ifstream f(input_file);
 
-    if (!parseInput(f, driving, src, dest, maxWalkTime, avoid_n, avoid_seg, inc_n, numVert)) return;
-
-    if (!avoid_n.empty() || !avoid_seg.empty() || inc_n != -1) {
-        restricted = true;
+    vector<string> blocks(1); // one per query, split by "---" lines
+    string line;
+    while (getline(f, line)) {
+        if (line.find_first_not_of("-\r") == string::npos && line.rfind("---", 0) == 0)
+            blocks.emplace_back();
+        else
+            blocks.back() += line + '\n';
     }
 
-    for (int i : avoid_n) {
-        if (i == inc_n || i == src || i == dest) {
-            cerr << "Error: Avoided node (" << i << ") cannot be the source ("
-                 << src << "), destination (" << dest << "), or include node ("
-                 << inc_n << ").\n";
+    vector<BatchQuery> queries(blocks.size());
+    LoadOptions options;
+    MatrixQuery matrix;
+    IsochroneQuery isochrone;
+
+    for (size_t k = 0; k < blocks.size(); k++) {
+        auto &q = queries[k];
+        istringstream block(blocks[k]);
+        matrix = {};
+        isochrone = {};
+
+        if (!parseInput(block, q.driving, q.src, q.dest, q.maxWalkTime, q.avoid_n, q.avoid_seg, q.waypoints, q.kShortest, numVert, options, matrix, isochrone)) {
+            if (blocks.size() > 1) cerr << "(query " << k + 1 << " of the batch)\n";
+            return;
+        }
+        if (blocks.size() > 1 && (matrix.enabled || isochrone.enabled)) {
+            cerr << "Error: matrix and isochrone queries cannot be part of a multi-query batch.\n";
             return;
         }
     }
 
-    const bool batch = true;
-
-    if (driving && !restricted)
-        driving_mode(g, src, dest, batch);
-    else if (driving && restricted)
-        driving_mode(g, src, dest, avoid_n, avoid_seg, inc_n, batch);
-    else {
-      if (approximate)
-        eco_mode_approximate(g, src, dest, maxWalkTime, avoid_n, avoid_seg, batch);
-      else
-        eco_mode(g, src, dest, maxWalkTime, avoid_n, avoid_seg, batch);
+    buildIndexes(g, options);
+    runBenchmarks(g, options);
+
+    if (matrix.enabled) {
+        matrix_mode(g, matrix, true);
+        return;
     }
+
+    if (isochrone.enabled) {
+        isochrone_mode(g, isochrone, queries[0].avoid_n, queries[0].avoid_seg, true);
+        return;
+    }
+
+    if (queries.size() > 1) {
+        runBatch(g, queries, approximate);
+    } else {
+#ifdef COUNT_ALLOCATIONS
+        reportSearchAllocations(g, queries[0].src);
+#endif
+        ostringstream answer;
+        if (answerQuery(g, queries[0], approximate, answer))
+            ofstream("output.txt") << answer.str();
+    }
+
+    if (options.treeCacheMiB > 0)
+        reportTreeCache(g);
 }
 
 // Manual Mode ---------------------------------------------------------------------------------------------------------
@@ -85,7 +121,8 @@ void batchMode(char *argv[], int argc) {
  * between driving mode and eco mode. Based on the user's inputs, it computes and displays the optimal route.
  */
 void manualMode() {
-    auto *g = new Graph<int>();
+    Graph<int> graph;
+    Graph<int> *g = &graph;
     string locations_file, distances_file;
 
     cout << "Location of the locations file: ";
@@ -98,6 +135,8 @@ void manualMode() {
 
     if (!parseDistances(g, distances_file)) return;
 
+    buildIndexes(g, LoadOptions());
+
     const int numVert = g->getNumVertex();
 
     while (true) {
@@ -178,8 +217,12 @@ void manualMode() {
                 }
             }
 
+            Waypoints waypoints;
+            if (inc_n != -1)
+                waypoints.nodes.push_back(inc_n);
+
             if (restricted)
-                driving_mode(g, src, dest, avoid_n, avoid_seg, inc_n);
+                driving_mode(g, src, dest, avoid_n, avoid_seg, waypoints);
             else
                 driving_mode(g, src, dest);
             return;
@@ -96,7 +96,7 @@ bool parseDistances (Graph<int> *g, const string &file) {
         if (line.find(',') == string::npos) continue;
 
         string code1, code2, checker;
-        double driving, walking;
+        Graph<int>::Weight driving, walking;
 
         size_t separator = line.find(',');
         code1 = line.substr(0, separator);
@@ -114,10 +114,10 @@ bool parseDistances (Graph<int> *g, const string &file) {
         line.erase(0, separator + 1);
 
         if (checker == "X")
-            driving = INF;
+            driving = WeightTraits<int>::NO_EDGE;
         else
             try {
-                driving = stoi(checker);
+                driving = parseMinutes(checker);
             } catch (...) {
                 cerr << "Invalid values detected.\n";
                 return false;
@@ -126,10 +126,10 @@ bool parseDistances (Graph<int> *g, const string &file) {
         checker = line;
 
         if (checker == "X")
-            walking = INF;
+            walking = WeightTraits<int>::NO_EDGE;
         else
             try {
-                walking = stoi(checker);
+                walking = parseMinutes(checker);
             } catch (...) {
                 cerr << "Invalid values detected.\n";
                 return false;
@@ -143,6 +143,20 @@ bool parseDistances (Graph<int> *g, const string &file) {
 
 // Auxiliary functions for parsing -------------------------------------------------------------------------------------
 
+/**
+ * @brief Parses a travel time (in whole minutes) from the distances file.
+ *
+ * @param text The field to parse.
+ * @return The travel time, as an edge weight of the graph.
+ * @throws std::invalid_argument or std::out_of_range if the field is not a number of minutes that fits in a weight.
+ */
+Graph<int>::Weight parseMinutes(const string &text) {
+    int minutes = stoi(text);
+    if (minutes < 0 || minutes >= WeightTraits<int>::NO_EDGE)
+        throw out_of_range("travel time out of range");
+    return minutes;
+}
+
 /**
  * @brief Parses a line of text to extract nodes to avoid.
  *
@@ -214,6 +228,30 @@ bool parseAvoidSegments(const string &line, vector<pair<int, int>> &avoid_seg) {
     return true;
 }
 
+/**
+ * @brief Parses a comma-separated list of vertex IDs.
+ *
+ * @param list The list, without its key.
+ * @param ids The vector to store the IDs.
+ * @return true if every entry is an ID, false otherwise.
+ */
+bool parseIDs(const string &list, vector<int> &ids) {
+
+    istringstream ss(list);
+    string id;
+
+    while (getline(ss, id, ',')) {
+        if (id.find_first_not_of(" \t\r\n") == string::npos) continue; // trailing comma or blank line end
+        try {
+            ids.push_back(stoi(id));
+        } catch (...) {
+            cerr << "Invalid ID list.\n";
+            return false;
+        }
+    }
+    return true;
+}
+
 // Input Parsing -------------------------------------------------------------------------------------------------------
 
 /**
@@ -222,18 +260,23 @@ bool parseAvoidSegments(const string &line, vector<pair<int, int>> &avoid_seg) {
  * This function reads an input file containing mode, source, destination, constraints,
  * and other parameters, and stores them in the provided variables.
  *
- * @param f The input file stream.
+ * @param f The input file stream, or one query's block of a multi-query batch.
  * @param driving A boolean indicating whether the mode is driving (true) or eco (false).
  * @param src The ID of the source vertex.
  * @param dest The ID of the destination vertex.
  * @param maxWalkTime The maximum allowed walking time (for eco mode).
  * @param avoid_n A vector to store nodes to avoid.
  * @param avoid_seg A vector to store segments to avoid.
- * @param inc_n The ID of a node to include in the route (if specified).
+ * @param waypoints The nodes to include in the route (if specified), and the order to visit them in.
+ * @param kShortest The number of driving routes asked for by "KShortest:<k>" (0 if not given).
  * @param numVert The total number of vertices in the graph.
+ * @param options The load options given in the file (e.g. "Adjacency:compressed").
+ * @param matrix The query of the matrix mode ("Mode:matrix"), which takes sources and targets instead of a source
+ * and a destination.
+ * @param isochrone The query of the isochrone mode ("Mode:isochrone"), which takes sources, a metric and a budget.
  * @return true if the input file was successfully parsed, false otherwise.
  */
-bool parseInput(ifstream &f, bool &driving, int &src, int &dest, int &maxWalkTime, vector<int> &avoid_n, vector<pair<int,int>> &avoid_seg, int &inc_n, const int numVert) {
+bool parseInput(istream &f, bool &driving, int &src, int &dest, int &maxWalkTime, vector<int> &avoid_n, vector<pair<int,int>> &avoid_seg, Waypoints &waypoints, int &kShortest, const int numVert, LoadOptions &options, MatrixQuery &matrix, IsochroneQuery &isochrone) {
 
     string line;
     bool hasMode = false, hasSrc = false, hasDest = false;
@@ -253,6 +296,12 @@ bool parseInput(ifstream &f, bool &driving, int &src, int &dest, int &maxWalkTim
             } else if (mode == "driving-walking") {
                 driving = false;
                 hasMode = true;
+            } else if (mode == "matrix") {
+                matrix.enabled = true;
+                hasMode = true;
+            } else if (mode == "isochrone") {
+                isochrone.enabled = true;
+                hasMode = true;
             } else {
                 cerr << "Invalid Mode.\n";
                 return false;
@@ -278,6 +327,58 @@ bool parseInput(ifstream &f, bool &driving, int &src, int &dest, int &maxWalkTim
                 return false;
             }
 
+        } else if (line.rfind("Sources:", 0) == 0) { // line starts with "Sources:"
+
+            if (!parseIDs(line.substr(8), matrix.sources)) return false;
+
+        } else if (line.rfind("Targets:", 0) == 0) { // line starts with "Targets:"
+
+            if (!parseIDs(line.substr(8), matrix.targets)) return false;
+
+        } else if (line.rfind("MatrixFormat:", 0) == 0) { // line starts with "MatrixFormat:"
+
+            string format = line.substr(13);
+            format.erase(0, format.find_first_not_of(" \t\r\n"));
+            format.erase(format.find_last_not_of(" \t\r\n") + 1);
+
+            if (format == "csv")
+                matrix.format = MatrixFormat::CSV;
+            else if (format == "binary")
+                matrix.format = MatrixFormat::Binary;
+            else {
+                cerr << "Invalid MatrixFormat (csv or binary).\n";
+                return false;
+            }
+
+        } else if (line.rfind("Metric:", 0) == 0) { // line starts with "Metric:"
+
+            string metric = line.substr(7);
+            metric.erase(0, metric.find_first_not_of(" \t\r\n"));
+            metric.erase(metric.find_last_not_of(" \t\r\n") + 1);
+
+            if (metric == "driving")
+                isochrone.metric = IsochroneMetric::Driving;
+            else if (metric == "walking")
+                isochrone.metric = IsochroneMetric::Walking;
+            else if (metric == "eco")
+                isochrone.metric = IsochroneMetric::Eco;
+            else {
+                cerr << "Invalid Metric (driving, walking or eco).\n";
+                return false;
+            }
+
+        } else if (line.rfind("Budget:", 0) == 0) { // line starts with "Budget:"
+
+            try {
+                isochrone.budget = stoi(line.substr(7));
+            } catch (...) {
+                isochrone.budget = -1;
+            }
+            if (isochrone.budget <= 0) {
+                cerr << "Invalid Budget (minutes, at least 1).\n";
+                return false;
+            }
+
         } else if (line.rfind("MaxWalkTime:", 0) == 0) { // line starts with "MaxWalkTime:"
 
             try {
@@ -286,6 +387,7 @@ bool parseInput(ifstream &f, bool &driving, int &src, int &dest, int &maxWalkTim
                     cerr << "Max walking time must be higher than 0.\n";
                     return false;
                 }
+                isochrone.walkBudget = maxWalkTime;
             } catch (...) {
                 cerr << "Max walking time must be specified.\n";
                 return false;
@@ -302,16 +404,204 @@ bool parseInput(ifstream &f, bool &driving, int &src, int &dest, int &maxWalkTim
         } else if (line.rfind("IncludeNode:", 0) == 0) { // line starts with "IncludeNode:"
 
             try {
-                inc_n = stoi(line.substr(12));
+                int inc_n = stoi(line.substr(12));
                 if (inc_n < -1 || inc_n >= numVert) {
                     cerr << "Node to include must exist in the graph.\n";
                     return false;
                 }
+                if (inc_n != -1) waypoints.nodes.push_back(inc_n);
+            } catch (...) {
+
+            }
+
+        } else if (line.rfind("IncludeNodes:", 0) == 0) { // line starts with "IncludeNodes:"
+
+            if (!parseIDs(line.substr(13), waypoints.nodes)) return false;
+
+        } else if (line.rfind("KShortest:", 0) == 0) { // line starts with "KShortest:"
+
+            try {
+                kShortest = stoi(line.substr(10));
             } catch (...) {
+                kShortest = -1;
+            }
+            if (kShortest <= 0) {
+                cerr << "Invalid KShortest (number of routes, at least 1).\n";
+                return false;
+            }
+
+        } else if (line.rfind("WaypointOrder:", 0) == 0) { // line starts with "WaypointOrder:"
 
+            string order = line.substr(14);
+            order.erase(0, order.find_first_not_of(" \t\r\n"));
+            order.erase(order.find_last_not_of(" \t\r\n") + 1);
+
+            if (order != "fixed" && order != "optimal") {
+                cerr << "Invalid WaypointOrder (fixed or optimal).\n";
+                return false;
             }
+            waypoints.optimise = order == "optimal";
+
+        } else if (line.rfind("Adjacency:", 0) == 0) { // line starts with "Adjacency:"
+
+            string layout = line.substr(10);
+            layout.erase(0, layout.find_first_not_of(" \t\r\n"));
+            layout.erase(layout.find_last_not_of(" \t\r\n") + 1);
+
+            if (layout == "compressed")
+                options.adjacency = AdjacencyLayout::Compressed;
+            else if (layout == "soa")
+                options.adjacency = AdjacencyLayout::SoA;
+            else if (layout == "plain")
+                options.adjacency = AdjacencyLayout::Plain;
+            else {
+                cerr << "Invalid Adjacency (plain, soa or compressed).\n";
+                return false;
+            }
+            options.reportAdjacency = true;
+
+        } else if (line.rfind("Reorder:", 0) == 0) { // line starts with "Reorder:"
 
+            string name = line.substr(8);
+            name.erase(0, name.find_first_not_of(" \t\r\n"));
+            name.erase(name.find_last_not_of(" \t\r\n") + 1);
+
+            options.order = parseVertexOrder(name);
+            if (!options.order) {
+                cerr << "Invalid Reorder (input, bfs or rcm).\n";
+                return false;
+            }
+
+        } else if (line.rfind("CacheStats:", 0) == 0) { // line starts with "CacheStats:"
+
+            string flag = line.substr(11);
+            flag.erase(0, flag.find_first_not_of(" \t\r\n"));
+            flag.erase(flag.find_last_not_of(" \t\r\n") + 1);
+
+            if (flag != "on" && flag != "off") {
+                cerr << "Invalid CacheStats (on or off).\n";
+                return false;
+            }
+            options.reportCacheMisses = flag == "on";
+
+        } else if (line.rfind("AllPairs:", 0) == 0) { // line starts with "AllPairs:"
+
+            string flag = line.substr(9);
+            flag.erase(0, flag.find_first_not_of(" \t\r\n"));
+            flag.erase(flag.find_last_not_of(" \t\r\n") + 1);
+
+            if (flag != "on" && flag != "off") {
+                cerr << "Invalid AllPairs (on or off).\n";
+                return false;
+            }
+            options.allPairs = flag == "on";
+
+        } else if (line.rfind("ArcFlags:", 0) == 0) { // line starts with "ArcFlags:"
+
+            try {
+                options.arcFlagRegions = stoi(line.substr(9));
+            } catch (...) {
+                options.arcFlagRegions = -1;
+            }
+            if (options.arcFlagRegions < 2 || options.arcFlagRegions > ArcFlags::MAX_REGIONS) {
+                cerr << "Invalid ArcFlags (number of regions, 2 to " << ArcFlags::MAX_REGIONS << ").\n";
+                return false;
+            }
+
+        } else if (line.rfind("DeltaStepping:", 0) == 0) { // line starts with "DeltaStepping:"
+
+            string flag = line.substr(14);
+            flag.erase(0, flag.find_first_not_of(" \t\r\n"));
+            flag.erase(flag.find_last_not_of(" \t\r\n") + 1);
+
+            if (flag == "on")
+                options.deltaStepping = true;
+            else if (flag == "off")
+                options.deltaStepping = false;
+            else if (flag == "auto")
+                options.deltaStepping.reset();
+            else {
+                cerr << "Invalid DeltaStepping (on, off or auto).\n";
+                return false;
+            }
+
+        } else if (line.rfind("HubLabels:", 0) == 0) { // line starts with "HubLabels:"
+
+            string flag = line.substr(10);
+            flag.erase(0, flag.find_first_not_of(" \t\r\n"));
+            flag.erase(flag.find_last_not_of(" \t\r\n") + 1);
+
+            if (flag != "on" && flag != "off") {
+                cerr << "Invalid HubLabels (on or off).\n";
+                return false;
+            }
+            options.hubLabels = flag == "on";
+
+        } else if (line.rfind("ParkingIndex:", 0) == 0) { // line starts with "ParkingIndex:"
+
+            try {
+                options.parkingBudget = stoi(line.substr(13));
+            } catch (...) {
+                options.parkingBudget = -1;
+            }
+            if (options.parkingBudget <= 0) {
+                cerr << "Invalid ParkingIndex (walking budget in minutes, at least 1).\n";
+                return false;
+            }
+
+        } else if (line.rfind("TreeCache:", 0) == 0) { // line starts with "TreeCache:"
+
+            try {
+                options.treeCacheMiB = stoi(line.substr(10));
+            } catch (...) {
+                options.treeCacheMiB = -1;
+            }
+            if (options.treeCacheMiB <= 0) {
+                cerr << "Invalid TreeCache (memory budget in MiB, at least 1).\n";
+                return false;
+            }
+
+        } else if (line.rfind("Benchmark:", 0) == 0) { // line starts with "Benchmark:"
+
+            string name = line.substr(10);
+            name.erase(0, name.find_first_not_of(" \t\r\n"));
+            name.erase(name.find_last_not_of(" \t\r\n") + 1);
+
+            if (name == "relax")
+                options.benchmarkRelax = true;
+            else if (name == "prefetch")
+                options.benchmarkPrefetch = true;
+            else {
+                cerr << "Invalid Benchmark (relax or prefetch).\n";
+                return false;
+            }
+
+        }
+    }
+
+    if (hasMode && matrix.enabled) { // sources and targets instead of a single pair
+        if (matrix.sources.empty() || matrix.targets.empty()) {
+            cerr << "Input file incomplete. Missing:\n";
+            if (matrix.sources.empty()) cerr << "Sources.\n";
+            if (matrix.targets.empty()) cerr << "Targets.\n";
+            return false;
+        }
+        return true;
+    }
+
+    if (hasMode && isochrone.enabled) { // sources and a budget instead of a pair; "Sources:" as in the matrix mode
+        isochrone.sources = matrix.sources;
+        if (isochrone.sources.empty() && hasSrc) isochrone.sources.push_back(src);
+
+        const bool walk = isochrone.metric != IsochroneMetric::Eco || isochrone.walkBudget > 0;
+        if (isochrone.sources.empty() || isochrone.budget <= 0 || !walk) {
+            cerr << "Input file incomplete. Missing:\n";
+            if (isochrone.sources.empty()) cerr << "Sources.\n";
+            if (isochrone.budget <= 0) cerr << "Budget.\n";
+            if (!walk) cerr << "MaxWalkTime.\n";
+            return false;
         }
+        return true;
     }
 
     if (!hasMode || !hasSrc || !hasDest) { // check for any missing components
@@ -0,0 +1,60 @@
+#include <cstring>
+#include <cerrno>
+
+#include "../headers/perf_counter.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Cache Miss Counter --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Opens the counter of last-level cache misses of the calling thread (user space only).
+ */
+CacheMissCounter::CacheMissCounter() {
+#ifdef __linux__
+    perf_event_attr attr{};
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_CACHE_MISSES;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+
+    fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    if (fd < 0)
+        reason = std::string("perf_event_open: ") + std::strerror(errno);
+#else
+    reason = "hardware counters are only read on Linux";
+#endif
+}
+
+CacheMissCounter::~CacheMissCounter() {
+#ifdef __linux__
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool CacheMissCounter::available() const {
+    return fd >= 0;
+}
+
+const std::string &CacheMissCounter::error() const {
+    return reason;
+}
+
+/**
+ * @brief Reads the counter; the difference between two reads is the number of misses in between.
+ *
+ * @return The number of cache misses counted so far, or 0 if the counter is not available.
+ */
+uint64_t CacheMissCounter::read() const {
+    uint64_t count = 0;
+#ifdef __linux__
+    if (fd >= 0 && ::read(fd, &count, sizeof(count)) != sizeof(count))
+        count = 0;
+#endif
+    return count;
+}
@@ -0,0 +1,404 @@
+#include <iostream>
+#include <queue>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <climits>
+
+#include "../headers/preprocessing.h"
+#include "../headers/algorithms.h"
+#include "../headers/perf_counter.h"
+
+using namespace std;
+
+// Vertex Renumbering --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Computes a breadth-first order of the vertices, so that neighbours get close indices.
+ *
+ * @param g The graph to order.
+ * @return The old index of the vertex to place at each position (see Graph::reorderVertices).
+ */
+vector<int> bfsOrder(Graph<int> *g) {
+    vector<int> order;
+    vector<bool> seen(g->getNumVertex(), false);
+    order.reserve(g->getNumVertex());
+
+    for (auto s:g->getVertexSet()) {
+        if (seen[s->getIndex()]) continue;
+
+        queue<Vertex<int>*> q;
+        q.push(s);
+        seen[s->getIndex()] = true;
+
+        while (!q.empty()) {
+            auto v = q.front();
+            q.pop();
+            order.push_back(v->getIndex());
+
+            for (auto e:v->getAdj()) {
+                auto w = e->getOther(v);
+                if (!seen[w->getIndex()]) {
+                    seen[w->getIndex()] = true;
+                    q.push(w);
+                }
+            }
+        }
+    }
+    return order;
+}
+
+/**
+ * @brief Computes a reverse Cuthill-McKee order of the vertices, which keeps the index gap between neighbours small.
+ *
+ * Segments are taken as undirected. Each connected component starts from a pseudo-peripheral vertex, and
+ * neighbours are visited by increasing degree.
+ *
+ * @param g The graph to order.
+ * @return The old index of the vertex to place at each position (see Graph::reorderVertices).
+ */
+vector<int> rcmOrder(Graph<int> *g) {
+    const int n = g->getNumVertex();
+    vector<int> order;
+    vector<bool> seen(n, false);
+    vector<int> level(n, -1);
+    vector<int> touched;
+    order.reserve(n);
+
+    auto degree = [](const Vertex<int> *v) { return v->getAdj().size() + v->getIncoming().size(); };
+    auto forEachNeighbour = [](Vertex<int> *v, auto &&f) {
+        for (auto e:v->getAdj()) f(e->getOther(v));
+        for (auto e:v->getIncoming()) f(e->getOrig());
+    };
+
+    // BFS levels from (root) over the vertices not ordered yet: returns the last level
+    auto lastLevel = [&](Vertex<int> *root) {
+        for (int i : touched) level[i] = -1;
+        touched.clear();
+
+        vector<Vertex<int>*> frontier = {root}, next;
+        level[root->getIndex()] = 0;
+        touched.push_back(root->getIndex());
+        while (true) {
+            next.clear();
+            for (auto v : frontier) {
+                forEachNeighbour(v, [&](Vertex<int> *w) {
+                    int i = w->getIndex();
+                    if (seen[i] || level[i] != -1) return;
+                    level[i] = level[v->getIndex()] + 1;
+                    touched.push_back(i);
+                    next.push_back(w);
+                });
+            }
+            if (next.empty()) return frontier;
+            frontier.swap(next);
+        }
+    };
+
+    for (auto s:g->getVertexSet()) {
+        if (seen[s->getIndex()]) continue;
+
+        // pseudo-peripheral root: move to a low-degree vertex of the last level while the eccentricity grows
+        auto root = s;
+        auto last = lastLevel(root);
+        int eccentricity = level[last[0]->getIndex()];
+        while (true) {
+            auto candidate = *min_element(last.begin(), last.end(), [&](auto a, auto b) { return degree(a) < degree(b); });
+            auto candidateLast = lastLevel(candidate);
+            int candidateEccentricity = level[candidateLast[0]->getIndex()];
+            if (candidateEccentricity <= eccentricity) break;
+            root = candidate;
+            last = candidateLast;
+            eccentricity = candidateEccentricity;
+        }
+
+        // Cuthill-McKee: breadth-first, neighbours by increasing degree
+        size_t head = order.size();
+        order.push_back(root->getIndex());
+        seen[root->getIndex()] = true;
+        vector<Vertex<int>*> neighbours;
+        while (head < order.size()) {
+            auto v = g->getVertex(order[head++]);
+            neighbours.clear();
+            forEachNeighbour(v, [&](Vertex<int> *w) {
+                if (seen[w->getIndex()]) return;
+                seen[w->getIndex()] = true;
+                neighbours.push_back(w);
+            });
+            stable_sort(neighbours.begin(), neighbours.end(), [&](auto a, auto b) { return degree(a) < degree(b); });
+            for (auto w : neighbours)
+                order.push_back(w->getIndex());
+        }
+    }
+
+    reverse(order.begin(), order.end());
+    return order;
+}
+
+/**
+ * @brief Parses the name of a vertex order ("input", "bfs" or "rcm").
+ *
+ * @param name The name, as written in the input file.
+ * @return The order, or nothing if the name is not valid.
+ */
+optional<VertexOrder> parseVertexOrder(const string &name) {
+    if (name == "input") return VertexOrder::Input;
+    if (name == "bfs") return VertexOrder::BFS;
+    if (name == "rcm") return VertexOrder::RCM;
+    return nullopt;
+}
+
+// Graph Partition -----------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Splits the vertices into (k) regions of nearby vertices, for the arc flags.
+ *
+ * The seeds are chosen farthest-first (in segments, taken as undirected), and each vertex joins the region of the
+ * closest seed. Vertices no seed reaches (small disconnected pieces) join region 0.
+ *
+ * @param g The graph to partition.
+ * @param k The number of regions.
+ * @return The region of each vertex, by index.
+ */
+vector<int> partitionRegions(Graph<int> *g, int k) {
+    const int n = g->getNumVertex();
+    vector<int> region(n, -1);
+    if (n == 0) return region;
+
+    auto forEachNeighbour = [](Vertex<int> *v, auto &&f) {
+        for (auto e:v->getAdj()) f(e->getOther(v));
+        for (auto e:v->getIncoming()) f(e->getOrig());
+    };
+
+    // hops to the nearest seed so far (INT_MAX: not reached by any)
+    vector<int> hops(n, INT_MAX);
+    auto multiSourceBFS = [&](const vector<int> &seeds) {
+        fill(hops.begin(), hops.end(), INT_MAX);
+        queue<int> q;
+        for (int r = 0; r < (int) seeds.size(); r++) {
+            hops[seeds[r]] = 0;
+            region[seeds[r]] = r;
+            q.push(seeds[r]);
+        }
+        while (!q.empty()) {
+            int i = q.front();
+            q.pop();
+            forEachNeighbour(g->getVertex(i), [&](Vertex<int> *w) {
+                if (hops[w->getIndex()] != INT_MAX) return;
+                hops[w->getIndex()] = hops[i] + 1;
+                region[w->getIndex()] = region[i];
+                q.push(w->getIndex());
+            });
+        }
+    };
+
+    vector<int> seeds = {0};
+    while ((int) seeds.size() < min(k, n)) {
+        multiSourceBFS(seeds);
+        int farthest = max_element(hops.begin(), hops.end()) - hops.begin();
+        if (hops[farthest] == 0) break; // every vertex is a seed already
+        seeds.push_back(farthest);
+    }
+    multiSourceBFS(seeds);
+
+    for (auto &r : region)
+        if (r == -1) r = 0;
+    return region;
+}
+
+// Load-time Indexing --------------------------------------------------------------------------------------------------
+
+/**
+ * @brief Builds the indexes requested by the load options, once both files have been parsed.
+ *
+ * @param g The loaded graph.
+ * @param options The load options read from the input file.
+ */
+void buildIndexes(Graph<int> *g, const LoadOptions &options) {
+    g->labelComponents(); // cheap, and lets queries between components be answered without searching
+
+    if (options.deltaStepping)
+        setDeltaSteppingThreshold(*options.deltaStepping ? 0 : INT_MAX);
+
+    auto order = options.order;
+    if (!order && options.adjacency == AdjacencyLayout::Compressed)
+        order = VertexOrder::BFS; // small neighbour deltas
+
+    vector<int> origins; // same sample before and after reordering, by ID
+    if (options.reportCacheMisses) {
+        const int n = g->getNumVertex(), samples = min(n, 16);
+        for (int i = 0; i < samples; i++)
+            origins.push_back(g->getVertex(i * n / samples)->getID());
+        reportSearchLocality(g, origins, "input");
+    }
+
+    if (order == VertexOrder::BFS)
+        g->reorderVertices(bfsOrder(g));
+    else if (order == VertexOrder::RCM)
+        g->reorderVertices(rcmOrder(g));
+
+    if (options.reportCacheMisses && order && *order != VertexOrder::Input)
+        reportSearchLocality(g, origins, *order == VertexOrder::BFS ? "bfs" : "rcm");
+
+    if (options.adjacency == AdjacencyLayout::Compressed)
+        g->compressAdjacency();
+    else if (options.adjacency == AdjacencyLayout::SoA)
+        g->buildSoAAdjacency();
+
+    if (options.reportAdjacency)
+        reportAdjacencyMemory(g);
+
+    if (options.allPairs) { // after reordering and the adjacency: the rows follow the final indices
+        auto start = chrono::steady_clock::now();
+        computeAllPairs(g, 0);
+        auto elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cerr << "All-pairs tables: " << g->getNumVertex() << " vertices, "
+             << (g->getDriveTable().bytes() + g->getWalkTable().bytes()) / (1024.0 * 1024.0) << " MiB, "
+             << elapsed << " ms\n";
+    }
+
+    if (options.arcFlagRegions > 0) {
+        auto start = chrono::steady_clock::now();
+        computeArcFlags(g, partitionRegions(g, options.arcFlagRegions), options.arcFlagRegions);
+        auto elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        cerr << "Arc flags: " << options.arcFlagRegions << " regions, "
+             << (g->getDriveFlags().bytes() + g->getWalkFlags().bytes()) / 1024.0 << " KiB, " << elapsed << " ms\n";
+    }
+
+    if (options.hubLabels) {
+        auto start = chrono::steady_clock::now();
+        computeHubLabels(g);
+        auto elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        for (int metric = 0; metric < 2; metric++) {
+            const auto &labels = metric == 0 ? g->getDriveLabels() : g->getWalkLabels();
+            cerr << (metric == 0 ? "Driving" : "Walking") << " hub labels: "
+                 << double(labels.numEntries()) / max(g->getNumVertex(), 1) << " hubs/vertex, "
+                 << labels.bytes() / 1024.0 << " KiB\n";
+        }
+        cerr << "Hub labels built in " << elapsed << " ms\n";
+    }
+
+    if (options.parkingBudget > 0) {
+        auto start = chrono::steady_clock::now();
+        computeParkingIndex(g, options.parkingBudget);
+        auto elapsed = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        const auto &index = g->getParkingIndex();
+        cerr << "Parking index: " << options.parkingBudget << " min, "
+             << double(index.numEntries()) / max(g->getNumVertex(), 1) << " parking/vertex, "
+             << index.bytes() / 1024.0 << " KiB, " << elapsed << " ms\n";
+    }
+
+    if (options.treeCacheMiB > 0)
+        g->getTreeCache().setBudget(size_t(options.treeCacheMiB) << 20);
+}
+
+/**
+ * @brief Reports on stderr the memory per edge of the plain (pointer per edge), structure-of-arrays and compressed
+ * adjacency of each metric.
+ *
+ * The layouts that are not in use are built just for the report.
+ *
+ * @param g The loaded graph.
+ */
+void reportAdjacencyMemory(Graph<int> *g) {
+    bool compressedBuilt = g->getCompressedDrive() != nullptr;
+    bool soaBuilt = g->getSoADrive() != nullptr;
+    if (!compressedBuilt) g->compressAdjacency(); // only to measure them
+    if (!soaBuilt) g->buildSoAAdjacency();
+
+    for (int metric = 0; metric < 2; metric++) {
+        size_t entries = 0, segments = 0;
+        for (auto v:g->getVertexSet()) {
+            for (auto e:metric == 0 ? v->getAdjDrive() : v->getAdjWalk()) {
+                entries++;
+                if (e->getOrig() == v) segments++; // a bidirectional segment is listed at both endpoints
+            }
+        }
+        if (entries == 0) continue;
+
+        // plain layout: one pointer per entry in the view, plus the Edge objects it points to
+        double plain = double(entries * sizeof(Edge<int>*) + segments * sizeof(Edge<int>)) / entries;
+
+        cerr << (metric == 0 ? "Driving" : "Walking") << " adjacency: " << entries << " edges, "
+             << plain << " bytes/edge plain" << (compressedBuilt || soaBuilt ? "" : " (in use)");
+
+        auto soa = metric == 0 ? g->getSoADrive() : g->getSoAWalk();
+        cerr << ", " << double(soa->bytes()) / entries << " bytes/edge soa" << (soaBuilt ? " (in use)" : "");
+
+        auto compressed = metric == 0 ? g->getCompressedDrive() : g->getCompressedWalk();
+        cerr << ", " << double(compressed->bytes()) / entries << " bytes/edge compressed"
+             << (compressedBuilt ? " (in use)" : "") << '\n';
+    }
+
+    if (!compressedBuilt) g->dropCompressedAdjacency();
+    if (!soaBuilt) g->dropSoAAdjacency();
+}
+
+/**
+ * @brief Reports on stderr how local the accesses of the searches are with the current vertex order.
+ *
+ * Prints the mean index gap between the endpoints of a segment, and the time and cache misses (when the hardware
+ * counter can be read) per settled vertex over driving and walking searches from the given origins.
+ *
+ * @param g The loaded graph.
+ * @param origins The IDs of the origins of the measured searches.
+ * @param label The name of the current order, for the report.
+ */
+void reportSearchLocality(Graph<int> *g, const vector<int> &origins, const string &label) {
+    if (origins.empty()) return;
+
+    double gap = 0;
+    size_t segments = 0;
+    for (auto v:g->getVertexSet()) {
+        for (auto e:v->getAdj()) {
+            if (e->getOrig() != v) continue; // each segment once
+            gap += abs(e->getOrig()->getIndex() - e->getDest()->getIndex());
+            segments++;
+        }
+    }
+
+    auto settled = [](const SearchTree<int> &tree) {
+        return count_if(tree.getDistances().begin(), tree.getDistances().end(), [](Distance d) { return d != INF; });
+    };
+
+    static CacheMissCounter counter; // opened once, read around the searches
+    driving_dijkstra(g, origins[0]); // warm up: size the search arrays
+    walking_dijkstra(g, origins[0]);
+
+    size_t vertices = 0;
+    uint64_t misses = counter.read();
+    auto start = chrono::steady_clock::now();
+    for (int origin : origins) {
+        driving_dijkstra(g, origin);
+        vertices += settled(g->getDriveTree());
+        walking_dijkstra(g, origin);
+        vertices += settled(g->getWalkTree());
+    }
+    auto elapsed = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+    misses = counter.read() - misses;
+
+    cerr << "Vertex order " << label << ": mean index gap " << (segments ? gap / segments : 0)
+         << ", " << elapsed / vertices << " ns";
+    if (counter.available())
+        cerr << " and " << double(misses) / vertices << " cache misses";
+    cerr << " per settled vertex";
+    if (!counter.available())
+        cerr << " (cache misses unavailable: " << counter.error() << ")";
+    cerr << '\n';
+}
+
+/**
+ * @brief Reports on stderr how the graph's tree cache did: hits, misses and hit rate, evictions, and the trees it
+ * holds against its budget.
+ *
+ * @param g The graph whose cache is reported.
+ */
+void reportTreeCache(Graph<int> *g) {
+    const auto &cache = g->getTreeCache();
+    const auto stats = cache.stats();
+    const size_t lookups = stats.hits + stats.misses;
+    cerr << "Tree cache: " << stats.hits << " hits, " << stats.misses << " misses ("
+         << (lookups ? 100.0 * stats.hits / lookups : 0.0) << "% hit rate), " << stats.evictions << " evictions, "
+         << cache.size() << " trees in " << cache.bytes() / (1024.0 * 1024.0) << " of "
+         << cache.budget() / (1024.0 * 1024.0) << " MiB\n";
+}
@@ -0,0 +1,93 @@
+#include "../headers/relax_kernels.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define RELAX_KERNELS_X86
+#endif
+
+namespace {
+
+uint64_t relaxMaskScalar(const uint32_t du, const int32_t *targets, const uint16_t *weights, const size_t n,
+                         const uint32_t *dist) {
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; i++)
+        mask |= uint64_t(du + weights[i] < dist[targets[i]]) << i;
+    return mask;
+}
+
+#ifdef RELAX_KERNELS_X86
+
+// Unsigned a < b on 32-bit lanes: max(a, b) != a. The scalar tail handles the entries that do not fill a vector.
+
+__attribute__((target("sse4.1")))
+uint64_t relaxMaskSSE41(const uint32_t du, const int32_t *targets, const uint16_t *weights, const size_t n,
+                        const uint32_t *dist) {
+    const __m128i base = _mm_set1_epi32(static_cast<int>(du));
+    uint64_t mask = 0;
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m128i w = _mm_cvtepu16_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i *>(weights + i)));
+        __m128i cand = _mm_add_epi32(base, w);
+        __m128i d = _mm_setr_epi32(static_cast<int>(dist[targets[i]]), static_cast<int>(dist[targets[i + 1]]),
+                                   static_cast<int>(dist[targets[i + 2]]), static_cast<int>(dist[targets[i + 3]]));
+        __m128i notLess = _mm_cmpeq_epi32(_mm_max_epu32(cand, d), cand);
+        uint64_t bits = ~_mm_movemask_ps(_mm_castsi128_ps(notLess)) & 0xF;
+        mask |= bits << i;
+    }
+    return mask | relaxMaskScalar(du, targets + i, weights + i, n - i, dist) << i;
+}
+
+__attribute__((target("avx2")))
+uint64_t relaxMaskAVX2(const uint32_t du, const int32_t *targets, const uint16_t *weights, const size_t n,
+                       const uint32_t *dist) {
+    const __m256i base = _mm256_set1_epi32(static_cast<int>(du));
+    uint64_t mask = 0;
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m256i w = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(weights + i)));
+        __m256i cand = _mm256_add_epi32(base, w);
+        __m256i idx = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(targets + i));
+        __m256i d = _mm256_i32gather_epi32(reinterpret_cast<const int *>(dist), idx, 4);
+        __m256i notLess = _mm256_cmpeq_epi32(_mm256_max_epu32(cand, d), cand);
+        uint64_t bits = ~_mm256_movemask_ps(_mm256_castsi256_ps(notLess)) & 0xFF;
+        mask |= bits << i;
+    }
+    return mask | relaxMaskScalar(du, targets + i, weights + i, n - i, dist) << i;
+}
+
+#endif
+
+std::vector<RelaxKernel> detectKernels() {
+    std::vector<RelaxKernel> kernels = {{"scalar", relaxMaskScalar}};
+#ifdef RELAX_KERNELS_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.1"))
+        kernels.push_back({"sse4.1", relaxMaskSSE41});
+    if (__builtin_cpu_supports("avx2"))
+        kernels.push_back({"avx2", relaxMaskAVX2});
+#endif
+    return kernels;
+}
+
+}
+
+// Block Relaxation Kernels --------------------------------------------------------------------------------------------
+
+/**
+ * @brief Returns the kernels this CPU can run, from the scalar fallback to the widest one.
+ *
+ * @return The available kernels; the last one is the one searches use.
+ */
+const std::vector<RelaxKernel> &availableRelaxKernels() {
+    static const std::vector<RelaxKernel> kernels = detectKernels();
+    return kernels;
+}
+
+/**
+ * @brief Returns the widest kernel this CPU can run (AVX2, then SSE4.1, then scalar), checked once via CPUID.
+ *
+ * @return The selected kernel.
+ */
+const RelaxKernel &relaxKernel() {
+    return availableRelaxKernels().back();
+}